@@ -0,0 +1,3 @@
+[OBJ] min -20 * exp(-0.2 * sqrt(sum(i, 1, 10, x[i]^2) / 10)) - exp(sum(i, 1, 10, cos(2 * pi * x[i])) / 10) + 20 + e
+[VAR] x[1..10], -32.768, 32.768, any
+[END]
@@ -0,0 +1,3 @@
+[OBJ] min -20 * exp(-0.2 * sqrt(sum(i, 1, 2, x[i]^2) / 2)) - exp(sum(i, 1, 2, cos(2 * pi * x[i])) / 2) + 20 + e
+[VAR] x[1..2], -32.768, 32.768, any
+[END]
@@ -0,0 +1,3 @@
+[OBJ] min -20 * exp(-0.2 * sqrt(sum(i, 1, 30, x[i]^2) / 30)) - exp(sum(i, 1, 30, cos(2 * pi * x[i])) / 30) + 20 + e
+[VAR] x[1..30], -32.768, 32.768, any
+[END]
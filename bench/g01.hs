@@ -0,0 +1,24 @@
+[OBJ] min 5 * (x1 + x2 + x3 + x4) - 5 * (x1^2 + x2^2 + x3^2 + x4^2) - (x5 + x6 + x7 + x8 + x9 + x10 + x11 + x12 + x13)
+[VAR] x1, 0, 1, any
+[VAR] x2, 0, 1, any
+[VAR] x3, 0, 1, any
+[VAR] x4, 0, 1, any
+[VAR] x5, 0, 1, any
+[VAR] x6, 0, 1, any
+[VAR] x7, 0, 1, any
+[VAR] x8, 0, 1, any
+[VAR] x9, 0, 1, any
+[VAR] x10, 0, 100, any
+[VAR] x11, 0, 100, any
+[VAR] x12, 0, 100, any
+[VAR] x13, 0, 1, any
+[ST] 2 * x1 + 2 * x2 + x10 + x11 <= 10
+[ST] 2 * x1 + 2 * x3 + x10 + x12 <= 10
+[ST] 2 * x2 + 2 * x3 + x11 + x12 <= 10
+[ST] -8 * x1 + x10 <= 0
+[ST] -8 * x2 + x11 <= 0
+[ST] -8 * x3 + x12 <= 0
+[ST] -2 * x4 - x5 + x10 <= 0
+[ST] -2 * x6 - x7 + x11 <= 0
+[ST] -2 * x8 - x9 + x12 <= 0
+[END]
@@ -0,0 +1,13 @@
+[OBJ] min 5.3578547 * x3^2 + 0.8356891 * x1 * x5 + 37.293239 * x1 - 40792.141
+[VAR] x1, 78, 102, any
+[VAR] x2, 33, 45, any
+[VAR] x3, 27, 45, any
+[VAR] x4, 27, 45, any
+[VAR] x5, 27, 45, any
+[ST] 85.334407 + 0.0056858 * x2 * x5 + 0.0006262 * x1 * x4 - 0.0022053 * x3 * x5 <= 92
+[ST] 85.334407 + 0.0056858 * x2 * x5 + 0.0006262 * x1 * x4 - 0.0022053 * x3 * x5 >= 0
+[ST] 80.51249 + 0.0071317 * x2 * x5 + 0.0029955 * x1 * x2 + 0.0021813 * x3^2 <= 110
+[ST] 80.51249 + 0.0071317 * x2 * x5 + 0.0029955 * x1 * x2 + 0.0021813 * x3^2 >= 90
+[ST] 9.300961 + 0.0047026 * x3 * x5 + 0.0012547 * x1 * x3 + 0.0019085 * x3 * x4 <= 25
+[ST] 9.300961 + 0.0047026 * x3 * x5 + 0.0012547 * x1 * x3 + 0.0019085 * x3 * x4 >= 20
+[END]
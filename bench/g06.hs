@@ -0,0 +1,6 @@
+[OBJ] min (x1 - 10)^3 + (x2 - 20)^3
+[VAR] x1, 13, 100, any
+[VAR] x2, 0, 100, any
+[ST] (x1 - 5)^2 + (x2 - 5)^2 >= 100
+[ST] (x1 - 6)^2 + (x2 - 5)^2 <= 82.81
+[END]
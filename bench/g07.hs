@@ -0,0 +1,20 @@
+[OBJ] min x1^2 + x2^2 + x1 * x2 - 14 * x1 - 16 * x2 + (x3 - 10)^2 + 4 * (x4 - 5)^2 + (x5 - 3)^2 + 2 * (x6 - 1)^2 + 5 * x7^2 + 7 * (x8 - 11)^2 + 2 * (x9 - 10)^2 + (x10 - 7)^2 + 45
+[VAR] x1, -10, 10, any
+[VAR] x2, -10, 10, any
+[VAR] x3, -10, 10, any
+[VAR] x4, -10, 10, any
+[VAR] x5, -10, 10, any
+[VAR] x6, -10, 10, any
+[VAR] x7, -10, 10, any
+[VAR] x8, -10, 10, any
+[VAR] x9, -10, 10, any
+[VAR] x10, -10, 10, any
+[ST] 4 * x1 + 5 * x2 - 3 * x7 + 9 * x8 <= 105
+[ST] 10 * x1 - 8 * x2 - 17 * x7 + 2 * x8 <= 0
+[ST] -8 * x1 + 2 * x2 + 5 * x9 - 2 * x10 <= 12
+[ST] 3 * (x1 - 2)^2 + 4 * (x2 - 3)^2 + 2 * x3^2 - 7 * x4 <= 120
+[ST] 5 * x1^2 + 8 * x2 + (x3 - 6)^2 - 2 * x4 <= 40
+[ST] x1^2 + 2 * (x2 - 2)^2 - 2 * x1 * x2 + 14 * x5 - 6 * x6 <= 0
+[ST] 0.5 * (x1 - 8)^2 + 2 * (x2 - 4)^2 + 3 * x5^2 - x6 <= 30
+[ST] -3 * x1 + 6 * x2 + 12 * (x9 - 8)^2 - 7 * x10 <= 0
+[END]
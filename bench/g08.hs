@@ -0,0 +1,6 @@
+[OBJ] max sin(2 * pi * x1)^3 * sin(2 * pi * x2) / (x1^3 * (x1 + x2))
+[VAR] x1, 0.001, 10, any
+[VAR] x2, 0, 10, any
+[ST] x1^2 - x2 + 1 <= 0
+[ST] 1 - x1 + (x2 - 4)^2 <= 0
+[END]
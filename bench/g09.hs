@@ -0,0 +1,13 @@
+[OBJ] min (x1 - 10)^2 + 5 * (x2 - 12)^2 + x3^4 + 3 * (x4 - 11)^2 + 10 * x5^6 + 7 * x6^2 + x7^4 - 4 * x6 * x7 - 10 * x6 - 8 * x7
+[VAR] x1, -10, 10, any
+[VAR] x2, -10, 10, any
+[VAR] x3, -10, 10, any
+[VAR] x4, -10, 10, any
+[VAR] x5, -10, 10, any
+[VAR] x6, -10, 10, any
+[VAR] x7, -10, 10, any
+[ST] 2 * x1^2 + 3 * x2^4 + x3 + 4 * x4^2 + 5 * x5 <= 127
+[ST] 7 * x1 + 3 * x2 + 10 * x3^2 + x4 - x5 <= 282
+[ST] 23 * x1 + x2^2 + 6 * x6^2 - 8 * x7 <= 196
+[ST] 4 * x1^2 + x2^2 - 3 * x1 * x2 + 2 * x3^2 + 5 * x6 - 11 * x7 <= 0
+[END]
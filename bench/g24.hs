@@ -0,0 +1,6 @@
+[OBJ] min -x1 - x2
+[VAR] x1, 0, 3, any
+[VAR] x2, 0, 4, any
+[ST] -2 * x1^4 + 8 * x1^3 - 8 * x1^2 + x2 <= 2
+[ST] -4 * x1^4 + 32 * x1^3 - 88 * x1^2 + 96 * x1 + x2 <= 36
+[END]
@@ -0,0 +1,3 @@
+[OBJ] min sum(i, 1, 2, x[i]^2) / 4000 - product(i, 1, 2, cos(x[i] / sqrt(i))) + 1
+[VAR] x[1..2], -600, 600, any
+[END]
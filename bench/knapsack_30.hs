@@ -0,0 +1,4 @@
+[OBJ] max 24 * x[1] + 31 * x[2] + 42 * x[3] + 38 * x[4] + 59 * x[5] + 55 * x[6] + 27 * x[7] + 19 * x[8] + 16 * x[9] + 48 * x[10] + 32 * x[11] + 14 * x[12] + 48 * x[13] + 31 * x[14] + 39 * x[15] + 35 * x[16] + 21 * x[17] + 34 * x[18] + 29 * x[19] + 32 * x[20] + 59 * x[21] + 59 * x[22] + 23 * x[23] + 17 * x[24] + 47 * x[25] + 25 * x[26] + 49 * x[27] + 55 * x[28] + 55 * x[29] + 55 * x[30]
+[VAR] x[1..30], 0, 1, int
+[ST] 9 * x[1] + 30 * x[2] + 7 * x[3] + 19 * x[4] + 38 * x[5] + 14 * x[6] + 39 * x[7] + 7 * x[8] + 6 * x[9] + 9 * x[10] + 25 * x[11] + 8 * x[12] + 6 * x[13] + 13 * x[14] + 40 * x[15] + 23 * x[16] + 38 * x[17] + 26 * x[18] + 10 * x[19] + 30 * x[20] + 35 * x[21] + 28 * x[22] + 14 * x[23] + 35 * x[24] + 34 * x[25] + 9 * x[26] + 34 * x[27] + 39 * x[28] + 12 * x[29] + 32 * x[30] <= 223
+[END]
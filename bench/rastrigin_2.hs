@@ -0,0 +1,3 @@
+[OBJ] min 20 + sum(i, 1, 2, x[i]^2 - 10 * cos(2 * pi * x[i]))
+[VAR] x[1..2], -5.12, 5.12, any
+[END]
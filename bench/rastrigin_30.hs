@@ -0,0 +1,3 @@
+[OBJ] min 300 + sum(i, 1, 30, x[i]^2 - 10 * cos(2 * pi * x[i]))
+[VAR] x[1..30], -5.12, 5.12, any
+[END]
@@ -0,0 +1,3 @@
+[OBJ] min sum(i, 1, 9, 100 * (x[i+1] - x[i]^2)^2 + (1 - x[i])^2)
+[VAR] x[1..10], -5, 10, any
+[END]
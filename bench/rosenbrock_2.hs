@@ -0,0 +1,3 @@
+[OBJ] min sum(i, 1, 1, 100 * (x[i+1] - x[i]^2)^2 + (1 - x[i])^2)
+[VAR] x[1..2], -5, 10, any
+[END]
@@ -0,0 +1,3 @@
+[OBJ] min 4189.829 - sum(i, 1, 10, x[i] * sin(sqrt(abs(x[i]))))
+[VAR] x[1..10], -500, 500, any
+[END]
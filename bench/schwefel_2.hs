@@ -0,0 +1,3 @@
+[OBJ] min 837.9658 - sum(i, 1, 2, x[i] * sin(sqrt(abs(x[i]))))
+[VAR] x[1..2], -500, 500, any
+[END]
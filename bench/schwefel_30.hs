@@ -0,0 +1,3 @@
+[OBJ] min 12569.487 - sum(i, 1, 30, x[i] * sin(sqrt(abs(x[i]))))
+[VAR] x[1..30], -500, 500, any
+[END]
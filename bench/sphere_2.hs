@@ -0,0 +1,3 @@
+[OBJ] min sum(i, 1, 2, x[i]^2)
+[VAR] x[1..2], -5.12, 5.12, any
+[END]
@@ -0,0 +1,254 @@
+// hsl_bench: bench/suite.csv의 모델을 여러 시드로 풀어 속도(평가/초)와 품질(목표 도달률, 도달 시간, ECDF)을 JSON으로 낸다.
+// 버전 사이의 성능 추적용. 진행 상황은 stderr로, 결과는 --output 파일(없으면 stdout)로 쓴다.
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../hs/params.h"
+#include "../hs/runner.h"
+
+namespace {
+
+    struct Entry {
+        std::string model;   // suite 파일 기준 경로
+        double target = 0.0;
+        unsigned int maxImp = 0;
+    };
+
+    struct Run {
+        unsigned int seed = 0;
+        double best = 0.0;
+        bool success = false;
+        std::uint64_t evaluations = 0; // 목적 함수 호출 수 (성공이면 목표 도달 시점까지)
+        double seconds = 0.0;
+    };
+
+    std::vector<Entry> loadSuite(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Cannot open benchmark suite: " + path);
+        std::vector<Entry> entries;
+        std::string line;
+        int lineNo = 0;
+        // "model,target,MaxImp" 한 줄씩. #으로 시작하는 줄과 빈 줄은 건너뜀
+        while (std::getline(in, line)) {
+            ++lineNo;
+            if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            std::stringstream ss(line);
+            std::string model, target, budget;
+            std::getline(ss, model, ',');
+            std::getline(ss, target, ',');
+            std::getline(ss, budget, ',');
+            Entry e;
+            e.model = model;
+            try {
+                e.target = std::stod(target);
+                e.maxImp = static_cast<unsigned int>(std::stoul(budget));
+            } catch (const std::exception&) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNo) + ": expected model,target,MaxImp");
+            }
+            entries.push_back(e);
+        }
+        return entries;
+    }
+
+    // JSON 숫자 (유한하지 않으면 null)
+    std::string number(double v) {
+        if (!std::isfinite(v)) return "null";
+        std::ostringstream ss;
+        ss << std::setprecision(12) << v;
+        return ss.str();
+    }
+
+    std::string quoted(const std::string& s) {
+        std::string r = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\') r += '\\';
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                r += buf;
+                continue;
+            }
+            r += c;
+        }
+        return r + "\"";
+    }
+
+    double percentile(std::vector<double> v, double q) {
+        if (v.empty()) return std::nan("");
+        std::sort(v.begin(), v.end());
+        double pos = q * static_cast<double>(v.size() - 1);
+        auto lo = static_cast<std::size_t>(pos);
+        std::size_t hi = std::min(lo + 1, v.size() - 1);
+        return v[lo] + (pos - static_cast<double>(lo)) * (v[hi] - v[lo]);
+    }
+
+}
+
+int main(int argc, char** argv) {
+    CLI::App app{"HS-L benchmark suite"};
+
+    std::string suite = "bench/suite.csv";
+    std::string param_file;
+    std::string output;
+    std::string filter;
+    std::string engine;
+    std::string label;
+    unsigned int seeds = 25;
+    unsigned int first_seed = 1;
+    double budget_scale = 1.0;
+
+    app.add_option("-s,--suite", suite, "Benchmark list: model,target,MaxImp per line (default: bench/suite.csv)");
+    app.add_option("-p,--param", param_file, "Base parameter file (.hsparm); MaxImp and Target come from the suite");
+    app.add_option("-o,--output", output, "JSON result file (default: stdout)");
+    app.add_option("--filter", filter, "Only run models whose file name contains this text");
+    app.add_option("--engine", engine, "Optimizer: HS, DE, PSO, CMAES, Pattern, Portfolio (default: from --param or HS)");
+    app.add_option("--label", label, "Free-form tag stored in the result (e.g. a version or commit)");
+    app.add_option("--seeds", seeds, "Runs per model (default: 25)");
+    app.add_option("--first_seed", first_seed, "Seed of the first run; run k uses first_seed + k (default: 1)");
+    app.add_option("--budget_scale", budget_scale, "Multiply every MaxImp in the suite by this factor (default: 1)");
+    CLI11_PARSE(app, argc, argv);
+
+    try {
+        hsl::HSParams base;
+        if (!param_file.empty()) base = hsl::loadParams(param_file);
+        if (app.count("--engine") && !hsl::parseEngine(engine, base.Engine))
+            throw std::runtime_error("Unknown engine: " + engine);
+        base.Quiet = true;
+        base.Checkpoint.clear();
+        base.Resume = false;
+
+        const std::filesystem::path root = std::filesystem::path(suite).parent_path();
+        std::vector<Entry> entries = loadSuite(suite);
+
+        std::ostringstream json;
+        std::time_t now = std::time(nullptr);
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        json << "{\n  \"suite\": " << quoted(suite) << ",\n"
+             << "  \"label\": " << quoted(label) << ",\n"
+             << "  \"date\": " << quoted(stamp) << ",\n"
+             << "  \"engine\": " << quoted(hsl::engineName(base.Engine)) << ",\n"
+             << "  \"variant\": " << quoted(hsl::variantName(base.Variant)) << ",\n"
+             << "  \"seeds\": " << seeds << ",\n"
+             << "  \"threads\": " << std::max(1u, std::thread::hardware_concurrency()) << ",\n"
+             << "  \"models\": [";
+
+        std::uint64_t totalEvaluations = 0;
+        double totalSeconds = 0.0;
+        unsigned int totalRuns = 0, totalSuccesses = 0;
+        bool firstModel = true;
+
+        for (const auto& entry : entries) {
+            if (!filter.empty() && entry.model.find(filter) == std::string::npos) continue;
+            hsl::HSParams params = base;
+            params.MaxImp = static_cast<unsigned int>(std::max(1.0, std::round(entry.maxImp * budget_scale)));
+            params.Target = entry.target;
+            const std::string path = (root / entry.model).string();
+            hsl::HSProblem problem = hsl::loadHSProblem(path, params);
+            std::ostream discard(nullptr);
+
+            std::vector<Run> runs;
+            for (unsigned int k = 0; k < seeds; ++k) {
+                Run r;
+                r.seed = first_seed + k;
+                hsl::HSResult res = hsl::runHarmonySearch(problem, params, r.seed, discard);
+                r.best = res.value;
+                r.seconds = res.cpu_time;
+                r.evaluations = res.stats.evaluations;
+                r.success = res.stats.stopReason == hsl::StopReason::Target;
+                runs.push_back(r);
+                std::cerr << "\r[bench] " << entry.model << "  " << (k + 1) << "/" << seeds << std::flush;
+            }
+
+            std::uint64_t evaluations = 0;
+            double seconds = 0.0;
+            std::vector<double> bests, successEvals, successSeconds;
+            for (const auto& r : runs) {
+                evaluations += r.evaluations;
+                seconds += r.seconds;
+                bests.push_back(r.best);
+                if (r.success) {
+                    successEvals.push_back(static_cast<double>(r.evaluations));
+                    successSeconds.push_back(r.seconds);
+                }
+            }
+            const std::size_t successes = successEvals.size();
+            const double rate = runs.empty() ? 0.0 : static_cast<double>(successes) / static_cast<double>(runs.size());
+            // ERT: 전체 평가 수 / 성공 횟수 (실패한 실행의 예산까지 포함한 기대 평가 수)
+            const double ert = successes ? static_cast<double>(evaluations) / static_cast<double>(successes)
+                                         : std::numeric_limits<double>::infinity();
+            std::cerr << "\r[bench] " << entry.model << "  success " << successes << "/" << runs.size()
+                      << ", " << std::fixed << std::setprecision(0)
+                      << (seconds > 0.0 ? static_cast<double>(evaluations) / seconds : 0.0) << " evals/s"
+                      << std::defaultfloat << std::endl;
+
+            json << (firstModel ? "\n" : ",\n") << "    {\n"
+                 << "      \"model\": " << quoted(entry.model) << ",\n"
+                 << "      \"variables\": " << problem.variables.size() << ",\n"
+                 << "      \"maximize\": " << (problem.maximize ? "true" : "false") << ",\n"
+                 << "      \"target\": " << number(entry.target) << ",\n"
+                 << "      \"max_imp\": " << params.MaxImp << ",\n"
+                 << "      \"runs\": " << runs.size() << ",\n"
+                 << "      \"successes\": " << successes << ",\n"
+                 << "      \"success_rate\": " << number(rate) << ",\n"
+                 << "      \"evaluations_per_second\": " << number(seconds > 0.0 ? evaluations / seconds : 0.0) << ",\n"
+                 << "      \"ert_evaluations\": " << number(ert) << ",\n"
+                 << "      \"time_to_target_median\": " << number(percentile(successSeconds, 0.5)) << ",\n"
+                 << "      \"evaluations_to_target_median\": " << number(percentile(successEvals, 0.5)) << ",\n"
+                 << "      \"best_median\": " << number(percentile(bests, 0.5)) << ",\n"
+                 << "      \"best_worst\": " << number(problem.maximize ? *std::min_element(bests.begin(), bests.end())
+                                                                     : *std::max_element(bests.begin(), bests.end()))
+                 << ",\n";
+            // ECDF: 평가 수 e까지 목표에 도달한 실행의 비율 (성공한 실행의 도달 평가 수마다 한 점)
+            std::sort(successEvals.begin(), successEvals.end());
+            json << "      \"ecdf\": [";
+            for (std::size_t i = 0; i < successEvals.size(); ++i)
+                json << (i ? ", " : "") << "[" << number(successEvals[i]) << ", "
+                     << number(static_cast<double>(i + 1) / static_cast<double>(runs.size())) << "]";
+            json << "],\n      \"results\": [";
+            for (std::size_t i = 0; i < runs.size(); ++i) {
+                const auto& r = runs[i];
+                json << (i ? "," : "") << "\n        {\"seed\": " << r.seed << ", \"best\": " << number(r.best)
+                     << ", \"success\": " << (r.success ? "true" : "false")
+                     << ", \"evaluations\": " << r.evaluations << ", \"seconds\": " << number(r.seconds) << "}";
+            }
+            json << "\n      ]\n    }";
+            firstModel = false;
+
+            totalEvaluations += evaluations;
+            totalSeconds += seconds;
+            totalRuns += static_cast<unsigned int>(runs.size());
+            totalSuccesses += static_cast<unsigned int>(successes);
+        }
+
+        json << "\n  ],\n  \"summary\": {\"runs\": " << totalRuns << ", \"successes\": " << totalSuccesses
+             << ", \"success_rate\": " << number(totalRuns ? static_cast<double>(totalSuccesses) / totalRuns : 0.0)
+             << ", \"evaluations\": " << totalEvaluations << ", \"seconds\": " << number(totalSeconds)
+             << ", \"evaluations_per_second\": " << number(totalSeconds > 0.0 ? totalEvaluations / totalSeconds : 0.0)
+             << "}\n}\n";
+
+        if (output.empty()) {
+            std::cout << json.str();
+        } else {
+            std::ofstream out(output);
+            if (!out) throw std::runtime_error("Cannot write benchmark result: " + output);
+            out << json.str();
+            std::cerr << "[INFO] Benchmark result written to " << output << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Error] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
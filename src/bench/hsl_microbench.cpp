@@ -0,0 +1,292 @@
+// hsl_microbench: 렉서, 파서, 목적식 평가, 즉흥 연주 루프의 구간별 비용 측정.
+// 각 항목을 warm-up 뒤 여러 번 반복해 중앙값과 10/90 백분위를 내고, 기준 파일(--baseline)과 비교해 퇴행을 표시한다.
+#include <CLI/CLI.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../interpreter/lexer.h"
+#include "../interpreter/parser.h"
+#include "../interpreter/evaluator.h"
+#include "../hs/hsalgorithm.h"
+#include "../utils/random.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        std::string name;
+        std::string unit;        // "ns/..."이면 작을수록, "M.../s"이면 클수록 좋다
+        double median = 0.0, p10 = 0.0, p90 = 0.0;
+        [[nodiscard]] bool lowerIsBetter() const { return unit.rfind("ns", 0) == 0; }
+    };
+
+    double percentile(std::vector<double> v, double q) {
+        std::sort(v.begin(), v.end());
+        double pos = q * static_cast<double>(v.size() - 1);
+        auto lo = static_cast<std::size_t>(pos);
+        std::size_t hi = std::min(lo + 1, v.size() - 1);
+        return v[lo] + (pos - static_cast<double>(lo)) * (v[hi] - v[lo]);
+    }
+
+    double seconds(Clock::time_point since) {
+        return std::chrono::duration<double>(Clock::now() - since).count();
+    }
+
+    volatile double sink = 0.0; // 최적화로 측정 대상이 사라지지 않도록
+
+    class Bench {
+    public:
+        Bench(int warmup, int reps, std::string filter) : warmup(warmup), reps(reps), filter(std::move(filter)) {}
+
+        // once()가 반복 1회를 돌고 단위에 맞는 값(ns/연산 또는 초당 처리량)을 돌려준다
+        void run(const std::string& name, const std::string& unit, const std::function<double()>& once) {
+            if (!filter.empty() && name.find(filter) == std::string::npos) return;
+            for (int i = 0; i < warmup; ++i) once();
+            std::vector<double> values;
+            for (int i = 0; i < reps; ++i) values.push_back(once());
+            Result r{name, unit, percentile(values, 0.5), percentile(values, 0.1), percentile(values, 0.9)};
+            std::cout << std::left << std::setw(28) << r.name << std::right << std::setw(14) << std::setprecision(4)
+                      << r.median << "  " << std::left << std::setw(14) << r.unit << std::right
+                      << "  p10 " << std::setw(10) << r.p10 << "  p90 " << std::setw(10) << r.p90 << std::endl;
+            results.push_back(r);
+        }
+
+        std::vector<Result> results;
+
+    private:
+        int warmup, reps;
+        std::string filter;
+    };
+
+    // AST 노드 수 (식 노드만)
+    std::size_t countNodes(const hsl::Expression* e) {
+        if (!e) return 0;
+        if (auto u = dynamic_cast<const hsl::UnaryExpr*>(e)) return 1 + countNodes(u->expr);
+        if (auto b = dynamic_cast<const hsl::BinaryExpr*>(e)) return 1 + countNodes(b->left) + countNodes(b->right);
+        if (auto f = dynamic_cast<const hsl::FunctionCallExpr*>(e)) {
+            std::size_t n = 1;
+            for (auto* a : f->args) n += countNodes(a);
+            return n;
+        }
+        if (auto ix = dynamic_cast<const hsl::IndexExpr*>(e)) return 1 + countNodes(ix->index);
+        return 1;
+    }
+
+    std::size_t countNodes(const hsl::Program* p) {
+        std::size_t n = countNodes(p->obj->expr);
+        for (auto* v : p->vars) n += countNodes(v->lower) + countNodes(v->upper) + countNodes(v->bandwidth);
+        for (auto* c : p->constraints) n += countNodes(c->left) + countNodes(c->right);
+        return n;
+    }
+
+    hsl::Program* parse(const std::string& src) {
+        hsl::Lexer lex(src);
+        hsl::Parser parser(lex);
+        hsl::Program* program = parser.parseProgram();
+        if (!parser.getErrors().empty()) throw std::runtime_error("Microbenchmark model failed to parse: " + parser.getErrors().front());
+        return program;
+    }
+
+    // 렉서/파서 측정용 큰 모델: 여러 모양의 항 terms개와 제약 몇 개
+    std::string largeModel(int terms) {
+        std::ostringstream s;
+        s << "[OBJ] min ";
+        for (int i = 0; i < terms; ++i) {
+            int a = i % 20 + 1, b = (i * 7) % 20 + 1;
+            if (i) s << " + ";
+            switch (i % 4) {
+                case 0: s << "3.25 * x[" << a << "] * x[" << b << "]"; break;
+                case 1: s << "(x[" << a << "] - " << i % 9 << ")^2"; break;
+                case 2: s << "sin(x[" << a << "]) * exp(-x[" << b << "] / 10)"; break;
+                default: s << "sqrt(abs(x[" << a << "] + 0.5))"; break;
+            }
+        }
+        s << "\n[VAR] x[1..20], -5, 5, any\n";
+        for (int i = 1; i <= 10; ++i) s << "[ST] x[" << i << "] + x[" << i + 10 << "] <= " << i << "\n";
+        s << "[END]\n";
+        return s.str();
+    }
+
+    // 목적식 하나의 평가 비용 (ns/평가)
+    void evalShape(Bench& bench, const std::string& name, const std::string& expr, int n, int calls) {
+        std::ostringstream src;
+        src << "[OBJ] min " << expr << "\n[VAR] x[1.." << n << "], -5, 5, any\n[END]\n";
+        hsl::HSProblem prob = hsl::buildHSProblem(parse(src.str()));
+        hsl::SplitMix64 rng{42};
+        std::vector<std::vector<double>> points(64, std::vector<double>(n));
+        for (auto& p : points) for (auto& v : p) v = rng.uniform() * 10.0 - 5.0;
+        bench.run("eval_" + name, "ns/eval", [&] {
+            double acc = 0.0;
+            auto t = Clock::now();
+            for (int i = 0; i < calls; ++i) acc += prob.objective(points[i & 63]);
+            double s = seconds(t);
+            sink = acc;
+            return s * 1e9 / calls;
+        });
+    }
+
+    // 즉흥 연주 1회의 비용 (평가 제외). 평가가 거의 공짜인 문제에서 MaxImp = 2N과 N의 시간 차이를 N으로 나눠
+    // 초기 HM 구성 비용을 뺀다. 목적 값은 변수 합이라 HM 교체(삽입)가 자주 일어난다
+    double improvisationCost(int HMS, int n, unsigned int iterations, hsl::HSVariant variant) {
+        hsl::HSProblem prob;
+        for (int i = 0; i < n; ++i) prob.variables.push_back({"x" + std::to_string(i), {-1.0, 1.0}, false});
+        prob.objective = [](const std::vector<double>& x) {
+            double s = 0.0;
+            for (double v : x) s += v;
+            return s;
+        };
+        prob.penalty = [](const std::vector<double>&) { return 0.0; };
+        prob.maximize = false;
+        hsl::HSParams params;
+        params.HMS = HMS;
+        params.Quiet = true;
+        params.CacheSize = 0;
+        params.Variant = variant;
+        auto timed = [&](unsigned int maxImp) {
+            params.MaxImp = maxImp;
+            hsl::HarmonySearch hs(prob, params, 7);
+            auto t = Clock::now();
+            sink = hs.optimize().value;
+            return seconds(t);
+        };
+        double full = timed(2 * iterations), half = timed(iterations);
+        return std::max(0.0, full - half) * 1e9 / iterations;
+    }
+
+    std::map<std::string, Result> loadBaseline(const std::string& path) {
+        std::map<std::string, Result> m;
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("Cannot open microbenchmark baseline: " + path);
+        std::string line;
+        // "name,unit,median,p10,p90" 한 줄씩 (#은 주석)
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::stringstream ss(line);
+            Result r;
+            std::string median, p10, p90;
+            std::getline(ss, r.name, ',');
+            std::getline(ss, r.unit, ',');
+            std::getline(ss, median, ',');
+            std::getline(ss, p10, ',');
+            std::getline(ss, p90, ',');
+            try {
+                r.median = std::stod(median);
+                r.p10 = std::stod(p10);
+                r.p90 = std::stod(p90);
+            } catch (const std::exception&) {
+                continue;
+            }
+            m[r.name] = r;
+        }
+        return m;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    CLI::App app{"HS-L microbenchmarks"};
+
+    int warmup = 3;
+    int reps = 15;
+    std::string filter;
+    std::string baseline;
+    std::string save;
+    double threshold = 0.10;
+
+    app.add_option("--warmup", warmup, "Untimed repetitions before measuring (default: 3)");
+    app.add_option("--reps", reps, "Timed repetitions per benchmark (default: 15)");
+    app.add_option("--filter", filter, "Only run benchmarks whose name contains this text");
+    app.add_option("--baseline", baseline, "Compare medians with this CSV (e.g. bench/microbench_baseline.csv)");
+    app.add_option("--save", save, "Write the results as a baseline CSV");
+    app.add_option("--threshold", threshold, "Relative slowdown reported as a regression (default: 0.10)");
+    CLI11_PARSE(app, argc, argv);
+
+    try {
+        if (reps < 1) throw std::runtime_error("--reps must be at least 1");
+        Bench bench(warmup, reps, filter);
+        std::cout << std::left << std::setw(28) << "benchmark" << std::right << std::setw(14) << "median" << std::endl;
+
+        // 1. 렉서 / 파서
+        const std::string source = largeModel(4000);
+        bench.run("lexer", "Mtokens/s", [&] {
+            std::size_t tokens = 0;
+            auto t = Clock::now();
+            hsl::Lexer lex(source);
+            while (lex.nextToken().type != hsl::TokenType::END_OF_FILE) ++tokens;
+            return static_cast<double>(tokens) / seconds(t) * 1e-6;
+        });
+        const std::size_t nodes = countNodes(parse(source));
+        bench.run("parser", "Mnodes/s", [&] {
+            auto t = Clock::now();
+            hsl::Program* program = parse(source); // AST는 해제하지 않는다 (실행기와 같음)
+            double s = seconds(t);
+            sink = static_cast<double>(program->constraints.size());
+            return static_cast<double>(nodes) / s * 1e-6;
+        });
+        bench.run("compile", "ns/node", [&] {
+            hsl::Program* program = parse(source);
+            auto t = Clock::now();
+            hsl::HSProblem prob = hsl::buildHSProblem(program);
+            double s = seconds(t);
+            sink = static_cast<double>(prob.variables.size());
+            return s * 1e9 / static_cast<double>(nodes);
+        });
+
+        // 2. 목적식 모양별 평가
+        evalShape(bench, "arith", "x[1] * x[2] + x[3] / (x[4] + 10) - 3.5 * x[5] + x[6] * x[7] - x[8]", 8, 200000);
+        evalShape(bench, "pow", "x[1]^2 + x[2]^3 + (x[3] + 6)^0.5 + x[4]^4 + (x[5] - 1)^2", 5, 200000);
+        evalShape(bench, "builtins", "sin(x[1]) + cos(x[2]) + exp(x[3] / 5) + sqrt(abs(x[4])) + log(1 + x[5]^2)", 5, 200000);
+        evalShape(bench, "sum10", "sum(i, 1, 10, (x[i] - i / 10)^2)", 10, 100000);
+        evalShape(bench, "sum100", "sum(i, 1, 100, (x[i] - i / 100)^2)", 100, 20000);
+        evalShape(bench, "sum1000", "sum(i, 1, 1000, (x[i] - i / 1000)^2)", 1000, 2000);
+
+        // 3. 즉흥 연주 루프 (평가 제외)와 HM 크기에 따른 삽입 비용
+        bench.run("improvise_HS", "ns/iter", [] { return improvisationCost(30, 10, 20000, hsl::HSVariant::HS); });
+        bench.run("improvise_SGHS", "ns/iter", [] { return improvisationCost(30, 10, 20000, hsl::HSVariant::SGHS); });
+        for (int hms : {10, 100, 1000})
+            bench.run("improvise_HMS" + std::to_string(hms), "ns/iter",
+                      [hms] { return improvisationCost(hms, 10, 20000, hsl::HSVariant::HS); });
+
+        if (!baseline.empty()) {
+            auto base = loadBaseline(baseline);
+            int regressions = 0;
+            std::cout << "\nCompared with " << baseline << ":" << std::endl;
+            for (const auto& r : bench.results) {
+                auto it = base.find(r.name);
+                if (it == base.end() || it->second.median <= 0.0) continue;
+                double change = r.median / it->second.median - 1.0;
+                double slowdown = r.lowerIsBetter() ? change : -change / (1.0 + change);
+                bool regressed = slowdown > threshold;
+                regressions += regressed;
+                std::cout << std::left << std::setw(28) << r.name << std::right << std::showpos << std::fixed
+                          << std::setprecision(1) << std::setw(8) << change * 100.0 << "%" << std::noshowpos
+                          << std::defaultfloat << (regressed ? "  REGRESSION" : "") << std::endl;
+            }
+            if (regressions) std::cout << "[WARN] " << regressions << " benchmark(s) slower than the baseline by more than "
+                                       << threshold * 100.0 << "%" << std::endl;
+        }
+
+        if (!save.empty()) {
+            std::ofstream out(save);
+            if (!out) throw std::runtime_error("Cannot write microbenchmark baseline: " + save);
+            out << "# name,unit,median,p10,p90\n" << std::setprecision(6);
+            for (const auto& r : bench.results)
+                out << r.name << ',' << r.unit << ',' << r.median << ',' << r.p10 << ',' << r.p90 << '\n';
+            std::cout << "[INFO] Baseline written to " << save << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Error] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -1,9 +1,13 @@
 #include <iostream>
+#include <algorithm>
 #include <iomanip>
 #include <random>
+#include <fstream>
+#include <sstream>
 #include <CLI/CLI.hpp>
 #include "hs/params.h"
 #include "hs/runner.h"
+#include "interpreter/profiler.h"
 
 int main(int argc, char** argv) {
     CLI::App app{"HS-L Command Line Interface"};
@@ -15,6 +19,45 @@ int main(int argc, char** argv) {
     double PAR = 0.7;
     unsigned int max_iter = 30000;
     unsigned int seed = std::random_device{}();
+    long cache_size = -1;
+    bool early_abort = true;
+    std::string variant;
+    std::string engine;
+    unsigned int pop_size = 0;
+    double target = 0.0;
+    unsigned int stall = 0;
+    double spread_eps = 0.0;
+    double time_limit = 0.0;
+    int restarts = 0;
+    unsigned long init_budget = 0;
+    std::string constraints;
+    std::string bandwidth;
+    bool dedup = false;
+    bool decompose = false;
+    int group_size = 0;
+    int cc_rounds = 0;
+    bool quiet = false;
+    bool surrogate = false;
+    unsigned int surrogate_size = 0;
+    double surrogate_explore = 0.0;
+    unsigned int workers = 0;
+    unsigned int in_flight = 0;
+    double eval_timeout = 0.0;
+    double dedup_tol = 0.0;
+    double penalty_weight = 0.0;
+    double eq_tolerance = 0.0;
+    std::string repair;
+    std::string checkpoint;
+    std::string warm_start;
+    unsigned int checkpoint_every = 0;
+    bool resume = false;
+    bool stats = false;
+    std::string trace;
+    unsigned int trace_every = 0;
+    double trace_interval = 0.0;
+    std::string stats_json;
+    bool profile_model = false;
+    unsigned int profile_every = 16;
 
 
     app.add_option("-s,--source", source_file, "HS-L source file (.hs)");
@@ -24,6 +67,45 @@ int main(int argc, char** argv) {
     app.add_option("--PAR", PAR, "Pitch Adjusting Rate (default: 0.7)");
     app.add_option("--max_iter", max_iter, "Maximum number of iterations (default: 30000)");
     app.add_option("--seed", seed, "Random seed (default: random_device)");
+    app.add_option("--variant", variant, "HS variant: HS, IHS, GHS, SGHS (default: HS)");
+    app.add_option("--engine", engine, "Optimizer: HS, DE, PSO, CMAES, Pattern, Portfolio (default: HS)");
+    app.add_option("--pop_size", pop_size, "Population size for DE/PSO/CMAES (0: engine default)");
+    app.add_option("--target", target, "Stop when the best value reaches this target");
+    app.add_option("--stall", stall, "Stop after this many iterations without improvement (0: off)");
+    app.add_option("--spread_eps", spread_eps, "Stop when the relative HM spread falls below this value (0: off)");
+    app.add_option("--time_limit", time_limit, "Wall-clock limit in seconds (0: off)");
+    app.add_option("--restarts", restarts, "Maximum number of restarts on stagnation (default: 0)");
+    app.add_option("--bandwidth", bandwidth, "Pitch bandwidth of variables without bw: Range, Spread (default: Range)");
+    app.add_flag("--dedup", dedup, "Reject candidates that duplicate an HM member before evaluating them");
+    app.add_option("--dedup_tol", dedup_tol, "Near-duplicate cell size for --dedup, as a fraction of each range (default: 0, exact)");
+    app.add_flag("--decompose", decompose, "Cooperative co-evolution over groups of variables that share objective terms/constraints");
+    app.add_option("--group_size", group_size, "Maximum number of variables per group for --decompose (default: 10)");
+    app.add_option("--cc_rounds", cc_rounds, "Rounds over all groups for --decompose (0: 1 if groups are independent, else 10)");
+    app.add_option("--trace", trace, "Record the convergence (iteration, evaluations, elapsed, best, worst, mean, diversity) to this file (.bin: binary, else CSV)");
+    app.add_option("--trace_every", trace_every, "Iterations between trace points (default: 100)");
+    app.add_option("--trace_interval", trace_interval, "Seconds between trace points; overrides --trace_every (0: off)");
+    app.add_flag("--stats", stats, "Count hot-path events (HM replacements, variable origins, [ST] rejections, time split) and print them");
+    app.add_option("--stats_json", stats_json, "Write the run statistics as one JSON object to this file (- for stdout)");
+    app.add_flag("--profile-model", profile_model, "Time expression nodes, sum bodies and [ST] on sampled evaluations and report the costs by source line:column");
+    app.add_option("--profile_every", profile_every, "Evaluations per profiled sample for --profile-model (default: 16)");
+    app.add_flag("--quiet", quiet, "Suppress progress and [INFO]/[WARN] output of the optimizer");
+    app.add_flag("--surrogate", surrogate, "Skip candidates whose RBF surrogate prediction cannot beat the HM worst");
+    app.add_option("--surrogate_size", surrogate_size, "Recent evaluations the surrogate is fitted on (0: 5 per variable, 50..500)");
+    app.add_option("--surrogate_explore", surrogate_explore, "Fraction of rejected candidates evaluated anyway (default: 0.1)");
+    app.add_option("--workers", workers, "Worker processes for an external objective (0: hardware threads)");
+    app.add_option("--in_flight", in_flight, "Requests queued per external worker (default: 2)");
+    app.add_option("--eval_timeout", eval_timeout, "Seconds before an external evaluation is abandoned (0: no limit)");
+    app.add_option("--constraints", constraints, "Constraint handling: Reject, Static, Adaptive, Epsilon, Deb (default: Deb)");
+    app.add_option("--penalty_weight", penalty_weight, "Violation weight for Static/Adaptive (default: 1000)");
+    app.add_option("--eq_tolerance", eq_tolerance, "Tolerance for equality constraints that cannot be solved in closed form (default: 1e-9)");
+    app.add_option("--repair", repair, "Repair stages for infeasible improvisations, e.g. Clamp+Resample+Greedy or None (default: all three)");
+    app.add_option("--warm_start", warm_start, "Seed the HM from a previous checkpoint or a CSV of solutions");
+    app.add_option("--checkpoint", checkpoint, "Write periodic checkpoints of the optimizer state to this file");
+    app.add_option("--checkpoint_every", checkpoint_every, "Iterations between checkpoints (default: 100000)");
+    app.add_flag("--resume", resume, "Continue from the --checkpoint file if it exists");
+    app.add_option("--init_budget", init_budget, "Maximum samples drawn to fill the initial HM (0: max(HMS*200, 10000))");
+    app.add_option("--early_abort", early_abort, "Stop evaluating candidates that cannot beat the HM worst (default: 1)");
+    app.add_option("--cache_size", cache_size, "Evaluation cache entries (-1: auto for small integer models, 0: off)");
     CLI11_PARSE(app, argc, argv);
 
     std::cout << "[INFO] Starting HS-L..." << std::endl;
@@ -46,13 +128,75 @@ int main(int argc, char** argv) {
         if (app.count("--HMCR"))   params.HMCR   = HMCR;
         if (app.count("--PAR"))    params.PAR    = PAR;
         if (app.count("--max_iter")) params.MaxImp = max_iter;
+        if (app.count("--cache_size")) params.CacheSize = cache_size;
+        if (app.count("--early_abort")) params.EarlyAbort = early_abort;
+        if (app.count("--target")) params.Target = target;
+        if (app.count("--stall")) params.StallWindow = stall;
+        if (app.count("--spread_eps")) params.SpreadEps = spread_eps;
+        if (app.count("--time_limit")) params.TimeLimit = time_limit;
+        if (app.count("--restarts")) params.Restarts = restarts;
+        if (app.count("--init_budget")) params.InitBudget = init_budget;
+        if (app.count("--variant") && !hsl::parseVariant(variant, params.Variant))
+            throw std::runtime_error("Unknown HS variant: " + variant);
+        if (app.count("--engine") && !hsl::parseEngine(engine, params.Engine))
+            throw std::runtime_error("Unknown engine: " + engine);
+        if (app.count("--pop_size")) params.PopSize = pop_size;
+        if (app.count("--penalty_weight")) params.PenaltyWeight = penalty_weight;
+        if (app.count("--eq_tolerance")) params.EqTolerance = eq_tolerance;
+        if (app.count("--warm_start")) params.WarmStart = warm_start;
+        if (app.count("--checkpoint")) params.Checkpoint = checkpoint;
+        if (app.count("--checkpoint_every")) params.CheckpointEvery = checkpoint_every;
+        if (resume) params.Resume = true;
+        if (params.Resume && params.Checkpoint.empty())
+            throw std::runtime_error("--resume needs a checkpoint file (--checkpoint <file>)");
+        if (app.count("--repair") && !hsl::parseRepairStages(repair, params.Repair))
+            throw std::runtime_error("Unknown repair stage: " + repair);
+        if (app.count("--bandwidth") && !hsl::parseBandwidthMode(bandwidth, params.Bandwidth))
+            throw std::runtime_error("Unknown bandwidth mode: " + bandwidth);
+        if (dedup) params.Dedup = true;
+        if (decompose) params.Decompose = true;
+        if (app.count("--group_size")) params.GroupSize = group_size;
+        if (app.count("--cc_rounds")) params.CCRounds = cc_rounds;
+        if (quiet) params.Quiet = true;
+        if (stats || !stats_json.empty()) params.Stats = true;
+        if (profile_model) params.ProfileModel = std::max(profile_every, 1u);
+        if (app.count("--trace")) params.Trace = trace;
+        if (app.count("--trace_every")) params.TraceEvery = trace_every;
+        if (app.count("--trace_interval")) params.TraceInterval = trace_interval;
+        if (surrogate) params.Surrogate = true;
+        if (app.count("--surrogate_size")) params.SurrogateSize = surrogate_size;
+        if (app.count("--surrogate_explore")) params.SurrogateExplore = surrogate_explore;
+        if (app.count("--workers")) params.Workers = workers;
+        if (app.count("--in_flight")) params.InFlight = in_flight;
+        if (app.count("--eval_timeout")) params.EvalTimeout = eval_timeout;
+        if (app.count("--dedup_tol")) params.DedupTol = dedup_tol;
+        if (app.count("--constraints") && !hsl::parseConstraintMode(constraints, params.Constraints))
+            throw std::runtime_error("Unknown constraint handling mode: " + constraints);
 
-        auto best = hsl::runHarmonySearchFromFile(source_file, params, seed, nullptr);
+        hsl::HSProblem problem = hsl::loadHSProblem(source_file, params);
+        std::ostream discard(nullptr);
+        hsl::HSResult result = hsl::runHarmonySearch(problem, params, seed, discard);
 
-        std::cout << "Best value: " << best.value << "\n";
-        for (size_t i = 0; i < best.vars.size(); ++i)
-            std::cout << "x[" << i + 1 << "] = " << best.vars[i] << "\n";
-        std::cout << std::fixed << std::setprecision(6);
+        std::cout << "Best value: " << result.value << "\n";
+        for (size_t i = 0; i < result.vars.size(); ++i)
+            std::cout << "x[" << i + 1 << "] = " << result.vars[i] << "\n";
+        std::cout << "CPU Time: " << result.cpu_time << " sec" << std::endl;
+
+        if (stats || params.Stats) hsl::printRunStats(std::cout, result, problem);
+        if (stats_json == "-") {
+            std::cout << hsl::runStatsJson(result, problem) << std::endl;
+        } else if (!stats_json.empty()) {
+            std::ofstream json(stats_json);
+            if (!json) throw std::runtime_error("Cannot write statistics to " + stats_json);
+            json << hsl::runStatsJson(result, problem) << "\n";
+            std::cout << "[INFO] Run statistics written to " << stats_json << std::endl;
+        }
+        if (problem.profiler) {
+            std::ifstream in(source_file);
+            std::stringstream text;
+            text << in.rdbuf();
+            hsl::printModelProfile(std::cout, *problem.profiler, text.str());
+        }
     } catch (const std::exception& e) {
         std::cerr << "[Error] " << e.what() << std::endl;
         return 1;
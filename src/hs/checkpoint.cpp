@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "checkpoint.h"
+#include "../interpreter/compiler.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace hsl {
+
+    namespace {
+        constexpr char kMagic[8] = {'H', 'S', 'L', 'C', 'K', 'P', 'T', '4'};
+        // HSStats 필드 목록의 판. 필드를 추가하면 올리고 getStats에서 이전 판은 새 필드를 0으로 둔다
+        constexpr std::uint32_t kStatsVersion = 1;
+
+        struct Fnv {
+            std::uint64_t h = 0xCBF29CE484222325ull;
+            void bytes(const void* p, std::size_t n) {
+                auto* c = static_cast<const unsigned char*>(p);
+                for (std::size_t i = 0; i < n; ++i) {
+                    h ^= c[i];
+                    h *= 0x100000001B3ull;
+                }
+            }
+            template <typename T> void add(const T& v) { bytes(&v, sizeof(v)); }
+            void add(const std::string& s) { add(s.size()); bytes(s.data(), s.size()); }
+        };
+
+        template <typename T> void put(std::ostream& out, const T& v) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+        }
+        void putString(std::ostream& out, const std::string& s) {
+            put<std::uint64_t>(out, s.size());
+            out.write(s.data(), static_cast<std::streamsize>(s.size()));
+        }
+        void putDoubles(std::ostream& out, const std::vector<double>& v) {
+            put<std::uint64_t>(out, v.size());
+            out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(double)));
+        }
+        void putHarmony(std::ostream& out, const Harmony& h) {
+            putDoubles(out, h.vars);
+            put(out, h.value);
+            put(out, h.violation);
+        }
+
+        template <typename T> T get(std::istream& in) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T v;
+            if (!in.read(reinterpret_cast<char*>(&v), sizeof(T))) throw std::runtime_error("Checkpoint file is truncated");
+            return v;
+        }
+        std::uint64_t getSize(std::istream& in) {
+            auto n = get<std::uint64_t>(in);
+            if (n > (1ull << 32)) throw std::runtime_error("Checkpoint file is corrupted");
+            return n;
+        }
+        std::string getString(std::istream& in) {
+            std::string s(getSize(in), '\0');
+            if (!in.read(s.data(), static_cast<std::streamsize>(s.size()))) throw std::runtime_error("Checkpoint file is truncated");
+            return s;
+        }
+        std::vector<double> getDoubles(std::istream& in) {
+            std::vector<double> v(getSize(in));
+            if (!in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(double))))
+                throw std::runtime_error("Checkpoint file is truncated");
+            return v;
+        }
+        Harmony getHarmony(std::istream& in) {
+            Harmony h{getDoubles(in), 0.0};
+            h.value = get<double>(in);
+            h.violation = get<double>(in);
+            return h;
+        }
+
+        // 구조체를 통째로 쓰면 필드 추가/패딩 변화에 파일이 말없이 어긋나므로 필드별로 쓴다
+        void putStats(std::ostream& out, const HSStats& s) {
+            put(out, kStatsVersion);
+            put(out, s.evaluations);
+            put(out, s.cacheLookups);
+            put(out, s.cacheHits);
+            put(out, s.earlyAborts);
+            put(out, s.bestFoundAt);
+            put<std::int32_t>(out, static_cast<std::int32_t>(s.stopReason));
+            put<std::uint32_t>(out, s.stopIteration);
+            put<std::int32_t>(out, s.restarts);
+            put(out, s.initSamples);
+            put(out, s.infeasible);
+            put(out, s.firstFeasibleAt);
+            put(out, s.repairAttempts);
+            put(out, s.repairSuccesses);
+            put(out, s.duplicatesSkipped);
+            put(out, s.surrogateSkipped);
+            put(out, s.surrogateChecked);
+            put(out, s.surrogateAgreed);
+        }
+        HSStats getStats(std::istream& in) {
+            auto version = get<std::uint32_t>(in);
+            if (version == 0 || version > kStatsVersion)
+                throw std::runtime_error("Checkpoint statistics version " + std::to_string(version) + " is not supported");
+            HSStats s;
+            s.evaluations = get<std::uint64_t>(in);
+            s.cacheLookups = get<std::uint64_t>(in);
+            s.cacheHits = get<std::uint64_t>(in);
+            s.earlyAborts = get<std::uint64_t>(in);
+            s.bestFoundAt = get<std::uint64_t>(in);
+            s.stopReason = static_cast<StopReason>(get<std::int32_t>(in));
+            s.stopIteration = get<std::uint32_t>(in);
+            s.restarts = get<std::int32_t>(in);
+            s.initSamples = get<std::uint64_t>(in);
+            s.infeasible = get<std::uint64_t>(in);
+            s.firstFeasibleAt = get<std::uint64_t>(in);
+            s.repairAttempts = get<std::uint64_t>(in);
+            s.repairSuccesses = get<std::uint64_t>(in);
+            s.duplicatesSkipped = get<std::uint64_t>(in);
+            s.surrogateSkipped = get<std::uint64_t>(in);
+            s.surrogateChecked = get<std::uint64_t>(in);
+            s.surrogateAgreed = get<std::uint64_t>(in);
+            return s;
+        }
+    }
+
+    std::uint64_t problemHash(const HSProblem& prob) {
+        Fnv f;
+        f.add(prob.variables.size());
+        for (const auto& v : prob.variables) {
+            f.add(v.name);
+            f.add(v.range.first);
+            f.add(v.range.second);
+            f.add(v.isInt);
+            f.add(v.bandwidth);
+        }
+        f.add(prob.maximize);
+        if (!prob.externalCommand.empty()) f.add(prob.externalCommand);
+        if (prob.model) {
+            // 내장 함수 포인터는 실행마다 주소가 달라질 수 있으므로 이름으로 반영
+            for (const auto& n : prob.model->nodes) {
+                f.add(n.op);
+                f.add(n.slot);
+                f.add(n.a);
+                f.add(n.b);
+                f.add(n.c);
+                f.add(n.value);
+                f.add(n.fn.arity);
+            }
+            for (const auto& [node, name] : prob.model->functions) {
+                f.add(node);
+                f.add(name);
+            }
+            for (const auto& c : prob.model->constraints) {
+                f.add(c.left);
+                f.add(c.right);
+                f.add(c.comparator);
+            }
+            f.add(prob.model->objective);
+            f.add(prob.model->eqTolerance);
+        }
+        return f.h;
+    }
+
+    void writeCheckpoint(const std::string& path, const Checkpoint& cp) {
+        const std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out) throw std::runtime_error("Cannot open checkpoint file for writing: " + tmp);
+            out.write(kMagic, sizeof(kMagic));
+            put(out, cp.problemHash);
+            put(out, cp.seed);
+            put(out, cp.evalCount);
+            put(out, cp.iteration);
+            put(out, cp.lastImprovement);
+            put(out, cp.lastRestart);
+            put(out, cp.elapsed);
+            putString(out, cp.rngState);
+            put<std::uint64_t>(out, cp.HM.size());
+            for (const auto& h : cp.HM) putHarmony(out, h);
+            putHarmony(out, cp.incumbent);
+            putStats(out, cp.stats);
+            put(out, cp.adaptive.HMCRm);
+            put(out, cp.adaptive.PARm);
+            putDoubles(out, cp.adaptive.goodHMCR);
+            putDoubles(out, cp.adaptive.goodPAR);
+            put(out, cp.penaltyWeight);
+            put(out, cp.penaltyRun);
+            put(out, cp.penaltyRunFeasible);
+            put(out, cp.epsilon0);
+            put(out, cp.epsilon);
+            out.flush();
+            if (!out) throw std::runtime_error("Failed to write checkpoint file: " + tmp);
+        }
+#ifdef _WIN32
+        // Windows의 rename은 대상이 있으면 실패하므로 교체를 명시한다
+        if (!MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+#else
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) // POSIX rename은 대상을 원자적으로 교체
+#endif
+            throw std::runtime_error("Failed to replace checkpoint file: " + path);
+    }
+
+    bool readCheckpoint(const std::string& path, Checkpoint& cp) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+
+        char magic[sizeof(kMagic)];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+            throw std::runtime_error("Not an HS-L checkpoint file: " + path);
+        cp.problemHash = get<std::uint64_t>(in);
+        cp.seed = get<std::uint64_t>(in);
+        cp.evalCount = get<std::uint64_t>(in);
+        cp.iteration = get<unsigned int>(in);
+        cp.lastImprovement = get<unsigned int>(in);
+        cp.lastRestart = get<unsigned int>(in);
+        cp.elapsed = get<double>(in);
+        cp.rngState = getString(in);
+        cp.HM.resize(getSize(in));
+        for (auto& h : cp.HM) h = getHarmony(in);
+        cp.incumbent = getHarmony(in);
+        cp.stats = getStats(in);
+        cp.adaptive.HMCRm = get<double>(in);
+        cp.adaptive.PARm = get<double>(in);
+        cp.adaptive.goodHMCR = getDoubles(in);
+        cp.adaptive.goodPAR = getDoubles(in);
+        cp.penaltyWeight = get<double>(in);
+        cp.penaltyRun = get<unsigned int>(in);
+        cp.penaltyRunFeasible = get<bool>(in);
+        cp.epsilon0 = get<double>(in);
+        cp.epsilon = get<double>(in);
+        if (cp.HM.empty()) throw std::runtime_error("Checkpoint file has an empty harmony memory: " + path);
+        return true;
+    }
+
+    std::vector<std::vector<double>> loadWarmStart(const std::string& path, const std::vector<Variable>& variables) {
+        std::vector<std::vector<double>> out;
+        {
+            std::ifstream probe(path, std::ios::binary);
+            if (!probe) throw std::runtime_error("Cannot open warm-start file: " + path);
+            char magic[sizeof(kMagic)] = {};
+            probe.read(magic, sizeof(magic));
+            if (probe && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0) {
+                // 데이터가 바뀐 모델에 쓰는 것이 목적이므로 모델 해시는 보지 않고 변수 수만 맞춘다
+                Checkpoint cp;
+                readCheckpoint(path, cp);
+                for (auto& h : cp.HM) {
+                    if (h.vars.size() != variables.size())
+                        throw std::runtime_error("Warm-start checkpoint has " + std::to_string(h.vars.size()) +
+                                                 " variables, the model has " + std::to_string(variables.size()));
+                    out.push_back(std::move(h.vars));
+                }
+                return out;
+            }
+        }
+
+        std::ifstream in(path);
+        std::vector<int> columns; // 변수 i의 값이 있는 열 번호
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(in, line)) {
+            ++lineNo;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.find_first_not_of(" \t") == std::string::npos || line[line.find_first_not_of(" \t")] == '#') continue;
+
+            std::vector<std::string> cells;
+            std::istringstream ss(line);
+            for (std::string cell; std::getline(ss, cell, ',');) {
+                auto b = cell.find_first_not_of(" \t"), e = cell.find_last_not_of(" \t");
+                cells.push_back(b == std::string::npos ? std::string{} : cell.substr(b, e - b + 1));
+            }
+
+            std::vector<double> numbers;
+            bool numeric = true;
+            for (const auto& c : cells) {
+                std::size_t used = 0;
+                try { numbers.push_back(std::stod(c, &used)); } catch (...) { used = 0; }
+                if (used == 0 || used != c.size()) { numeric = false; break; }
+            }
+
+            if (!numeric) {
+                if (!out.empty() || !columns.empty())
+                    throw std::runtime_error("Warm-start file " + path + ": non-numeric value at line " + std::to_string(lineNo));
+                for (const auto& v : variables) {
+                    auto it = std::find(cells.begin(), cells.end(), v.name);
+                    if (it == cells.end())
+                        throw std::runtime_error("Warm-start file " + path + ": no column for variable " + v.name);
+                    columns.push_back(static_cast<int>(it - cells.begin()));
+                }
+                continue;
+            }
+
+            if (columns.empty())
+                for (std::size_t i = 0; i < variables.size(); ++i) columns.push_back(static_cast<int>(i));
+            std::vector<double> x(variables.size());
+            for (std::size_t i = 0; i < variables.size(); ++i) {
+                if (static_cast<std::size_t>(columns[i]) >= numbers.size())
+                    throw std::runtime_error("Warm-start file " + path + ": too few values at line " + std::to_string(lineNo));
+                x[i] = numbers[static_cast<std::size_t>(columns[i])];
+            }
+            out.push_back(std::move(x));
+        }
+        return out;
+    }
+
+    CheckpointWriter::CheckpointWriter(std::string path)
+            : path(std::move(path)), worker([this] { run(); }) {}
+
+    CheckpointWriter::~CheckpointWriter() {
+        close();
+    }
+
+    void CheckpointWriter::close() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join(); // 남은 스냅숏은 run이 기록하고 끝낸다
+    }
+
+    void CheckpointWriter::submit(Checkpoint& snapshot) {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            if (stopping) return;
+            std::swap(back, snapshot);
+            pending = true;
+        }
+        cv.notify_all();
+    }
+
+    std::string CheckpointWriter::takeError() {
+        std::lock_guard<std::mutex> lk(m);
+        return std::exchange(error, std::string{});
+    }
+
+    void CheckpointWriter::run() {
+        Checkpoint front;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk, [this] { return pending || stopping; });
+                if (!pending) return;
+                std::swap(front, back);
+                pending = false;
+            }
+            try {
+                writeCheckpoint(path, front);
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lk(m);
+                error = e.what();
+            }
+        }
+    }
+
+}
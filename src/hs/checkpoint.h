@@ -0,0 +1,83 @@
+#ifndef HSL_CHECKPOINT_
+#define HSL_CHECKPOINT_
+// 긴 실행을 중단 지점부터 이어가기 위한 최적화 상태 스냅숏 (이진 파일)과 백그라운드 기록기.
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "hsalgorithm.h"
+#include "../utils/jthread.h"
+
+namespace hsl {
+
+    // optimize 루프를 같은 결과로 이어가는 데 필요한 상태 전부.
+    // 평가 캐시는 담지 않는다 (적중 여부와 무관하게 같은 값이 나오므로 탐색 경로는 같고 통계만 달라진다).
+    struct Checkpoint {
+        std::uint64_t problemHash = 0;
+        std::uint64_t seed = 0;
+        std::uint64_t evalCount = 0;
+        unsigned int iteration = 0;        // 다음에 수행할 반복 번호
+        unsigned int lastImprovement = 0;
+        unsigned int lastRestart = 0;
+        double elapsed = 0.0;              // 누적 실행 시간 (초, TimeLimit 용)
+        std::string rngState;              // mt19937 텍스트 표현
+        std::vector<Harmony> HM;
+        Harmony incumbent{};
+        HSStats stats;
+        AdaptiveState adaptive;
+        double penaltyWeight = 0.0;
+        unsigned int penaltyRun = 0;
+        bool penaltyRunFeasible = false;
+        double epsilon0 = 0.0;
+        double epsilon = 0.0;
+    };
+
+    // 변수 선언과 컴파일된 식 구조로 만든 해시. 다른 모델의 체크포인트로 이어가는 것을 막는다.
+    std::uint64_t problemHash(const HSProblem& prob);
+
+    // path.tmp에 쓴 뒤 이름을 바꿔 교체하므로 기록 도중 중단돼도 이전 체크포인트는 남는다. 실패 시 예외.
+    // 바이트 순서는 기록한 기계 기준 (같은 빌드로 이어가는 용도)
+    void writeCheckpoint(const std::string& path, const Checkpoint& cp);
+    // 파일이 없으면 false. 형식이 맞지 않으면 예외.
+    bool readCheckpoint(const std::string& path, Checkpoint& cp);
+
+    // 웜 스타트용 해 벡터 목록을 읽는다. 체크포인트 파일이면 그 HM을, 아니면 CSV(한 줄에 해 하나)를 읽는다.
+    // CSV 첫 줄이 숫자가 아니면 변수 이름 머리글로 보고 이름으로 열을 찾는다 (나머지 열은 무시, 예: 목적 값 열).
+    // 머리글이 없으면 앞에서부터 변수 순서대로. 읽을 수 없으면 예외.
+    std::vector<std::vector<double>> loadWarmStart(const std::string& path, const std::vector<Variable>& variables);
+
+    // 이중 버퍼 체크포인트 기록기. submit은 버퍼를 맞바꾸기만 하고 돌아오며, 파일 기록은 전용 스레드가 한다.
+    // 기록이 밀리면 아직 기록하지 않은 스냅숏은 더 새 것으로 대체된다.
+    class CheckpointWriter {
+    public:
+        explicit CheckpointWriter(std::string path);
+        ~CheckpointWriter(); // 남은 스냅숏을 기록하고 종료
+
+        CheckpointWriter(const CheckpointWriter&) = delete;
+        CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+        // snapshot과 대기 버퍼를 맞바꾼다. 돌아온 snapshot은 다음 스냅숏용 재사용 버퍼
+        void submit(Checkpoint& snapshot);
+        // 마지막 기록 실패 메시지를 꺼낸다 (없으면 빈 문자열)
+        std::string takeError();
+        // 남은 스냅숏을 기록하고 스레드를 끝낸다. 이후 submit은 무시된다
+        void close();
+
+    private:
+        std::string path;
+        std::mutex m;
+        std::condition_variable cv;
+        Checkpoint back;       // 다음에 기록할 스냅숏
+        bool pending = false;
+        bool stopping = false;
+        std::string error;
+        jthread worker;        // 마지막에 선언 (다른 멤버가 준비된 뒤 시작)
+
+        void run();
+    };
+
+}
+
+#endif
@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include "coevolution.h"
+#include "io.h"
+#include "../interpreter/compiler.h"
+#include "../utils/threadpool.h"
+
+namespace hsl {
+
+    namespace {
+        // 부분 문제 평가용 전체 변수 벡터. 묶음 하나의 탐색은 한 스레드에서만 평가하므로 스레드마다 하나면 된다
+        std::vector<double>& scratch() {
+            thread_local std::vector<double> s;
+            return s;
+        }
+
+        int findRoot(std::vector<int>& parent, int v) {
+            while (parent[v] != v) {
+                parent[v] = parent[parent[v]];
+                v = parent[v];
+            }
+            return v;
+        }
+    }
+
+    CooperativeSearch::CooperativeSearch(const HSProblem& prob, const HSParams& params, unsigned int seed)
+            : problem(prob), params(params), out(params.Quiet ? silent : hsl::cout), seed(seed) {}
+
+    // 조각/제약으로 이어진 변수끼리 같은 연결 성분. 작은 성분은 GroupSize까지 합치고, 큰 성분은 변수 순서대로 나눈다
+    void CooperativeSearch::partition() {
+        const auto& model = *problem.model;
+        const int n = static_cast<int>(problem.variables.size());
+        std::vector<int> parent(static_cast<std::size_t>(n));
+        std::iota(parent.begin(), parent.end(), 0);
+        auto unite = [&](const std::vector<int>& vars) {
+            for (std::size_t k = 1; k < vars.size(); ++k)
+                parent[findRoot(parent, vars[k])] = findRoot(parent, vars[0]);
+        };
+        for (const auto& s : model.slices) unite(s.variables);
+        for (const auto& c : model.constraints) unite(c.variables);
+
+        std::vector<std::vector<int>> members(static_cast<std::size_t>(n));
+        for (int v = 0; v < n; ++v) members[findRoot(parent, v)].push_back(v);
+        std::vector<std::vector<int>> comps;
+        for (auto& m : members)
+            if (!m.empty()) comps.push_back(std::move(m));
+        std::sort(comps.begin(), comps.end(), [](const auto& a, const auto& b) { return a.front() < b.front(); });
+        components = comps.size();
+
+        const auto limit = static_cast<std::size_t>(std::max(params.GroupSize, 1));
+        std::vector<int> current;
+        auto flush = [&](std::vector<int>& vars) {
+            if (vars.empty()) return;
+            Group g;
+            g.variables = std::move(vars);
+            std::sort(g.variables.begin(), g.variables.end());
+            groups.push_back(std::move(g));
+            vars.clear();
+        };
+        for (auto& comp : comps) {
+            if (comp.size() > limit) {
+                flush(current);
+                for (std::size_t k = 0; k < comp.size(); k += limit) {
+                    std::vector<int> chunk(comp.begin() + static_cast<std::ptrdiff_t>(k),
+                                           comp.begin() + static_cast<std::ptrdiff_t>(std::min(k + limit, comp.size())));
+                    flush(chunk);
+                }
+                continue;
+            }
+            if (current.size() + comp.size() > limit) flush(current);
+            current.insert(current.end(), comp.begin(), comp.end());
+        }
+        flush(current);
+
+        owner.assign(static_cast<std::size_t>(n), -1);
+        position.assign(static_cast<std::size_t>(n), -1);
+        for (std::size_t g = 0; g < groups.size(); ++g) {
+            for (std::size_t k = 0; k < groups[g].variables.size(); ++k) {
+                owner[groups[g].variables[k]] = static_cast<int>(g);
+                position[groups[g].variables[k]] = static_cast<int>(k);
+            }
+        }
+    }
+
+    // 묶음별 관련 조각/제약을 정하고, 공유하는 묶음끼리 다른 색이 되도록 탐욕 색칠한 색을 단계로 쓴다
+    void CooperativeSearch::schedule() {
+        const auto& model = *problem.model;
+        std::vector<std::vector<int>> conflicts(groups.size());
+        std::vector<int> touched;
+        auto attach = [&](const std::vector<int>& vars, int id, std::vector<int> Group::*list) {
+            touched.clear();
+            for (int v : vars) touched.push_back(owner[v]);
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+            for (int g : touched) {
+                (groups[g].*list).push_back(id);
+                for (int h : touched)
+                    if (h != g) conflicts[g].push_back(h);
+            }
+        };
+        for (std::size_t s = 0; s < model.slices.size(); ++s)
+            attach(model.slices[s].variables, static_cast<int>(s), &Group::slices);
+        for (std::size_t c = 0; c < model.constraints.size(); ++c)
+            attach(model.constraints[c].variables, static_cast<int>(c), &Group::constraints);
+        for (std::size_t r = 0; r < model.equalityRepairs.size(); ++r)
+            groups[owner[model.equalityRepairs[r].pivot]].repairs.push_back(static_cast<int>(r));
+
+        std::vector<int> color(groups.size(), -1);
+        std::vector<char> used;
+        for (std::size_t g = 0; g < groups.size(); ++g) {
+            auto& adj = conflicts[g];
+            std::sort(adj.begin(), adj.end());
+            adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+            used.assign(adj.size() + 1, 0);
+            for (int h : adj)
+                if (color[h] >= 0 && color[h] < static_cast<int>(used.size())) used[color[h]] = 1;
+            int c = 0;
+            while (used[c]) ++c;
+            color[g] = c;
+            if (c >= static_cast<int>(stages.size())) stages.resize(c + 1);
+            stages[c].push_back(static_cast<int>(g));
+        }
+    }
+
+    // 스레드의 scratch에 묶음 값 x를 써 넣는다 (나머지 변수는 탐색 시작 시 복사한 문맥 값)
+    std::vector<double>& CooperativeSearch::load(const Group& g, const std::vector<double>& x) const {
+        auto& full = scratch();
+        for (std::size_t k = 0; k < g.variables.size(); ++k) full[g.variables[k]] = x[k];
+        return full;
+    }
+
+    void CooperativeSearch::buildSubproblem(Group& g) {
+        const auto model = problem.model;
+        HSProblem& sub = g.problem;
+        for (int v : g.variables) sub.variables.push_back(problem.variables[v]);
+        sub.maximize = problem.maximize;
+        sub.stochastic = problem.stochastic;
+        sub.parallelSafe = false; // scratch를 공유하므로 한 스레드에서만 평가
+
+        const Group* grp = &g;
+        sub.objectiveSeeded = [this, grp, model](const std::vector<double>& x, std::uint64_t stream) {
+            EvalContext ctx;
+            ctx.vars = load(*grp, x).data();
+            ctx.rng.state = stream;
+            double total = 0.0;
+            for (int s : grp->slices) total += model->evalSlice(model->slices[s], ctx);
+            return total;
+        }; // 다른 묶음에만 걸린 조각은 상수이므로 빼고 계산
+
+        sub.violationSeeded = [this, grp, model](const std::vector<double>& x, std::uint64_t stream) {
+            EvalContext ctx;
+            ctx.vars = load(*grp, x).data();
+            ctx.rng.state = stream;
+            double total = 0.0;
+            for (int c : grp->constraints) total += model->violation(model->constraints[c], ctx);
+            return total;
+        };
+        sub.penaltySeeded = [f = sub.violationSeeded](const std::vector<double>& x, std::uint64_t stream) {
+            return f(x, stream) > 0.0 ? std::numeric_limits<double>::infinity() : 0.0;
+        };
+        sub.constraintViolations = [this, grp, model](const std::vector<double>& x, std::uint64_t stream,
+                                                      std::vector<double>& violations) {
+            EvalContext ctx;
+            ctx.vars = load(*grp, x).data();
+            ctx.rng.state = stream;
+            violations.resize(grp->constraints.size());
+            for (std::size_t i = 0; i < violations.size(); ++i)
+                violations[i] = model->violation(model->constraints[grp->constraints[i]], ctx);
+        };
+        for (int c : g.constraints) {
+            std::vector<int> local;
+            for (int v : model->constraints[c].variables)
+                if (owner[v] == owner[g.variables.front()]) local.push_back(position[v]);
+            sub.constraintVariables.push_back(std::move(local));
+        }
+
+        if (!g.repairs.empty()) {
+            sub.repair = [this, grp, model](std::vector<double>& x) {
+                auto& full = load(*grp, x);
+                for (int r : grp->repairs) model->repairEquality(model->equalityRepairs[r], full.data());
+                for (std::size_t k = 0; k < x.size(); ++k) x[k] = full[grp->variables[k]];
+            };
+        }
+
+        sub.objective = [f = sub.objectiveSeeded](const std::vector<double>& x) { return f(x, 0); };
+        sub.penalty = [f = sub.penaltySeeded](const std::vector<double>& x) { return f(x, 0); };
+    }
+
+    // 공유 문맥을 전체 문제로 평가
+    Harmony CooperativeSearch::assemble(std::uint64_t stream) const {
+        Harmony h{context, 0.0};
+        h.value = problem.objectiveSeeded ? problem.objectiveSeeded(context, stream) : problem.objective(context);
+        if (problem.violationSeeded) h.violation = problem.violationSeeded(context, stream);
+        return h;
+    }
+
+    void CooperativeSearch::accumulate(const HSStats& s) {
+        statistics.evaluations += s.evaluations;
+        statistics.cacheLookups += s.cacheLookups;
+        statistics.cacheHits += s.cacheHits;
+        statistics.earlyAborts += s.earlyAborts;
+        statistics.initSamples += s.initSamples;
+        statistics.infeasible += s.infeasible;
+        statistics.repairAttempts += s.repairAttempts;
+        statistics.repairSuccesses += s.repairSuccesses;
+        statistics.duplicatesSkipped += s.duplicatesSkipped;
+        statistics.surrogateSkipped += s.surrogateSkipped;
+        statistics.surrogateChecked += s.surrogateChecked;
+        statistics.surrogateAgreed += s.surrogateAgreed;
+        statistics.restarts += s.restarts;
+    }
+
+    // 묶음의 계수기를 더한다. 제약별 위반은 묶음 안의 번호를 전체 [ST] 번호로 옮긴다
+    void CooperativeSearch::accumulate(const Group& g, const RunCounters& c) {
+        RunCounters mapped = c;
+        mapped.rejections.assign(problem.constraintVariables.size(), 0);
+        for (std::size_t i = 0; i < c.rejections.size() && i < g.constraints.size(); ++i)
+            mapped.rejections[static_cast<std::size_t>(g.constraints[i])] += c.rejections[i];
+        gathered.merge(mapped);
+    }
+
+    Harmony CooperativeSearch::optimize() {
+        auto start = std::chrono::steady_clock::now();
+        if (!problem.model || problem.model->slices.empty()) {
+            out << "[WARN] Decompose needs a model compiled with objective slices; running a single search." << std::endl;
+            HarmonySearch hs(problem, params, static_cast<unsigned int>(seed));
+            Harmony best = hs.optimize();
+            statistics = hs.stats();
+            gathered = hs.counters();
+            return best;
+        }
+
+        partition();
+        if (groups.size() <= 1) {
+            out << "[INFO] Decompose: the model does not split into groups; running a single search." << std::endl;
+            HarmonySearch hs(problem, params, static_cast<unsigned int>(seed));
+            Harmony best = hs.optimize();
+            statistics = hs.stats();
+            gathered = hs.counters();
+            return best;
+        }
+        schedule();
+        for (auto& g : groups) buildSubproblem(g);
+
+        const bool independent = stages.size() == 1;
+        const int rounds = params.CCRounds > 0 ? params.CCRounds : (independent ? 1 : 10);
+        const unsigned int iterations = std::max(1u, params.MaxImp / static_cast<unsigned int>(rounds));
+        out << "[INFO] Decompose: " << problem.variables.size() << " variables, " << components
+            << " components, " << groups.size() << " groups in " << stages.size() << " parallel stage(s), "
+            << rounds << " round(s) of " << iterations << " improvisations per group" << std::endl;
+
+        // 초기 문맥: 범위 안의 균등 표본
+        SplitMix64 g0{deriveStream(seed, 0)};
+        context.resize(problem.variables.size());
+        for (std::size_t i = 0; i < context.size(); ++i) {
+            const auto& var = problem.variables[i];
+            double v = var.range.first + g0.uniform() * (var.range.second - var.range.first);
+            context[i] = var.isInt ? std::clamp(std::round(v), var.range.first, var.range.second) : v;
+        }
+
+        HSParams sub = params;
+        sub.MaxImp = iterations;
+        sub.Quiet = true;
+        sub.Decompose = false;
+        sub.WarmStart.clear();
+        sub.Checkpoint.clear();
+        sub.Trace.clear();
+        sub.Resume = false;
+        sub.Surrogate = false; // 묶음의 부분 평가는 조각만 계산하므로 싸다
+        sub.TimeLimit = 0.0; // 시간 한도는 단계 사이에서 검사
+        sub.Target = std::numeric_limits<double>::quiet_NaN(); // 부분 목적 값은 전체 값과 비교할 수 없음
+
+        ThreadPool& pool = ThreadPool::shared();
+        std::uint64_t runIndex = 1;
+        Harmony best = assemble(deriveStream(seed, runIndex++));
+        int round = 0;
+        for (; round < rounds && statistics.stopReason == StopReason::MaxImp; ++round) {
+            for (const auto& stage : stages) {
+                std::vector<std::vector<double>> results(stage.size());
+                std::vector<HSStats> subStats(stage.size());
+                std::vector<RunCounters> subCounters(stage.size());
+                const std::uint64_t base = runIndex;
+                pool.parallelFor(stage.size(), [&](std::size_t k) {
+                    Group& g = groups[stage[k]];
+                    scratch() = context;
+                    std::vector<double> current(g.variables.size());
+                    for (std::size_t j = 0; j < current.size(); ++j) current[j] = context[g.variables[j]];
+
+                    HarmonySearch hs(g.problem, sub, static_cast<unsigned int>(deriveStream(seed, base + k)));
+                    auto presets = std::move(g.memory);
+                    presets.insert(presets.begin(), current);
+                    hs.presetMemory(std::move(presets));
+                    Harmony found = hs.optimize();
+
+                    g.memory.clear();
+                    for (const auto& h : hs.memory()) g.memory.push_back(h.vars);
+                    subStats[k] = hs.stats();
+                    subCounters[k] = hs.counters();
+
+                    // 현재 값보다 나빠지지 않을 때만 문맥에 반영 (같은 스트림으로 다시 평가해 비교)
+                    const std::uint64_t stream = deriveStream(seed, base + k) ^ 0x9E3779B97F4A7C15ull;
+                    double curViolation = g.problem.violationSeeded(current, stream);
+                    double curValue = g.problem.objectiveSeeded(current, stream);
+                    bool better = found.violation < curViolation ||
+                                  (found.violation == curViolation &&
+                                   (problem.maximize ? found.value >= curValue : found.value <= curValue));
+                    results[k] = better ? std::move(found.vars) : std::move(current);
+                });
+                runIndex += stage.size();
+
+                for (std::size_t k = 0; k < stage.size(); ++k) {
+                    const Group& g = groups[stage[k]];
+                    for (std::size_t j = 0; j < g.variables.size(); ++j) context[g.variables[j]] = results[k][j];
+                    accumulate(subStats[k]);
+                    if (params.Stats) accumulate(g, subCounters[k]);
+                }
+
+                if (params.TimeLimit > 0.0 &&
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= params.TimeLimit) {
+                    statistics.stopReason = StopReason::TimeLimit;
+                    break;
+                }
+            }
+
+            Harmony h = assemble(deriveStream(seed, runIndex++));
+            bool improved = h.violation < best.violation ||
+                            (h.violation == best.violation &&
+                             (problem.maximize ? h.value > best.value : h.value < best.value));
+            if (improved) statistics.bestFoundAt = statistics.evaluations;
+            best = std::move(h);
+            out << "[INFO] Round " << round + 1 << "/" << rounds << ": value " << best.value;
+            if (best.violation > 0.0) out << " (violation " << best.violation << ")";
+            out << std::endl;
+
+            if (!std::isnan(params.Target) && best.violation == 0.0 &&
+                (problem.maximize ? best.value >= params.Target : best.value <= params.Target))
+                statistics.stopReason = StopReason::Target;
+        }
+        statistics.stopIteration = static_cast<unsigned int>(round);
+        if (statistics.stopReason != StopReason::MaxImp)
+            out << "[INFO] Stopped early (" << stopReasonName(statistics.stopReason) << ") after round " << round << std::endl;
+        out << "[INFO] Decompose: " << statistics.evaluations << " group evaluations" << std::endl;
+        return best;
+    }
+
+}
@@ -0,0 +1,59 @@
+#ifndef HSL_COEVOLUTION_
+#define HSL_COEVOLUTION_
+
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include "hsalgorithm.h"
+#include "params.h"
+#include "../interpreter/evaluator.h"
+
+namespace hsl {
+
+    // 협력 공진화 (Decompose). 목적식 조각(ObjectiveSlice)과 제약이 함께 쓰는 변수를 연결 성분으로 묶은 뒤
+    // GroupSize 이하의 묶음으로 합치거나 나눈다. 묶음마다 나머지 변수를 공유 문맥(현재 해)에 고정한 부분 문제를
+    // HarmonySearch로 풀며, 부분 문제의 평가는 그 묶음의 변수가 나타나는 조각/제약만 계산한다.
+    // 조각이나 제약을 공유하지 않는 묶음끼리는 같은 단계로 모아 스레드 풀에서 동시에 푼다.
+    class CooperativeSearch : public Solver {
+    public:
+        CooperativeSearch(const HSProblem& prob, const HSParams& params, unsigned int seed);
+        Harmony optimize() override;
+        [[nodiscard]] const HSStats& stats() const override { return statistics; }
+        [[nodiscard]] RunCounters counters() const override { return gathered; }
+
+    private:
+        struct Group {
+            std::vector<int> variables;   // 전체 변수 번호 (오름차순)
+            std::vector<int> slices;      // 이 묶음의 변수가 나타나는 목적식 조각
+            std::vector<int> constraints; // 이 묶음의 변수가 나타나는 제약
+            std::vector<int> repairs;     // 기준 변수가 이 묶음에 있는 등식 보정 (적용 순서)
+            HSProblem problem;
+            std::vector<std::vector<double>> memory; // 지난 라운드의 마지막 HM (다음 라운드 초기 HM 후보)
+        };
+
+        const HSProblem& problem;
+        HSParams params;
+        std::ostream silent{nullptr};
+        std::ostream& out;
+        std::uint64_t seed;
+        std::vector<Group> groups;
+        std::vector<int> owner;               // 변수 -> 묶음 번호
+        std::vector<int> position;            // 변수 -> 묶음 안의 위치
+        std::vector<std::vector<int>> stages; // 같은 단계의 묶음끼리는 조각/제약을 공유하지 않음
+        std::size_t components = 0;
+        std::vector<double> context;          // 공유 문맥 (모든 변수의 현재 값)
+        HSStats statistics;
+        RunCounters gathered;                 // Stats: 묶음 HS 계수기의 합 ([ST] 번호는 전체 모델 기준)
+
+        void partition();
+        void schedule();
+        void buildSubproblem(Group& g);
+        std::vector<double>& load(const Group& g, const std::vector<double>& x) const;
+        Harmony assemble(std::uint64_t stream) const;
+        void accumulate(const HSStats& s);
+        void accumulate(const Group& g, const RunCounters& c);
+    };
+
+}
+
+#endif
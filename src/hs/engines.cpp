@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "engines.h"
+
+namespace hsl {
+
+    namespace {
+        // [0, n)
+        std::size_t pick(SplitMix64& rng, std::size_t n) {
+            return std::min(n - 1, static_cast<std::size_t>(rng.uniform() * static_cast<double>(n)));
+        }
+
+        double span(const Variable& v) { return v.range.second - v.range.first; }
+    }
+
+    // ---- 차분 진화 ----
+
+    DifferentialEvolution::DifferentialEvolution(const HSProblem& prob, const HSParams& params, unsigned int seed)
+            : StepSolver(prob, params, seed, "DE") {}
+
+    void DifferentialEvolution::initialize() {
+        const std::size_t n = problem.variables.size();
+        std::size_t size = params.PopSize ? params.PopSize : std::clamp<std::size_t>(10 * n, 20, 100);
+        population.resize(std::max<std::size_t>(size, 4));
+        for (auto& h : population) h.vars = randomPoint();
+        evaluateAll(population);
+    }
+
+    void DifferentialEvolution::step() {
+        constexpr double F = 0.5, CR = 0.9;
+        const std::size_t np = population.size(), n = problem.variables.size();
+        trials.resize(np);
+        for (std::size_t i = 0; i < np; ++i) {
+            std::size_t r1, r2, r3;
+            do r1 = pick(rng, np); while (r1 == i);
+            do r2 = pick(rng, np); while (r2 == i || r2 == r1);
+            do r3 = pick(rng, np); while (r3 == i || r3 == r1 || r3 == r2);
+            const std::size_t forced = pick(rng, n);
+            auto& x = trials[i].vars;
+            x = population[i].vars;
+            for (std::size_t j = 0; j < n; ++j) {
+                if (j == forced || rng.uniform() < CR)
+                    x[j] = population[r1].vars[j] + F * (population[r2].vars[j] - population[r3].vars[j]);
+            }
+        }
+        evaluateAll(trials);
+        for (std::size_t i = 0; i < np; ++i)
+            if (!better(population[i], trials[i])) population[i] = trials[i];
+    }
+
+    void DifferentialEvolution::inject(const Harmony& h) {
+        StepSolver::inject(h);
+        if (population.empty()) return;
+        auto worst = std::max_element(population.begin(), population.end(),
+                                      [this](const Harmony& a, const Harmony& b) { return better(a, b); });
+        if (better(h, *worst)) *worst = h;
+    }
+
+    // ---- 입자 군집 ----
+
+    ParticleSwarm::ParticleSwarm(const HSProblem& prob, const HSParams& params, unsigned int seed)
+            : StepSolver(prob, params, seed, "PSO") {}
+
+    void ParticleSwarm::initialize() {
+        const std::size_t n = problem.variables.size();
+        const std::size_t size = params.PopSize ? params.PopSize : 40;
+        position.resize(size);
+        velocity.assign(size, std::vector<double>(n, 0.0));
+        swarm.resize(size);
+        for (std::size_t k = 0; k < size; ++k) {
+            position[k] = randomPoint();
+            for (std::size_t j = 0; j < n; ++j)
+                velocity[k][j] = (rng.uniform() - 0.5) * 0.2 * span(problem.variables[j]);
+            swarm[k].vars = position[k];
+        }
+        evaluateAll(swarm);
+        personal = swarm;
+    }
+
+    void ParticleSwarm::step() {
+        constexpr double w = 0.7298, c1 = 1.49618, c2 = 1.49618;
+        const std::size_t n = problem.variables.size();
+        const auto& global = bestSoFar.vars;
+        for (std::size_t k = 0; k < position.size(); ++k) {
+            auto& x = position[k];
+            auto& v = velocity[k];
+            for (std::size_t j = 0; j < n; ++j) {
+                const auto& var = problem.variables[j];
+                const double vmax = 0.2 * span(var);
+                v[j] = w * v[j] + c1 * rng.uniform() * (personal[k].vars[j] - x[j])
+                       + c2 * rng.uniform() * (global[j] - x[j]);
+                v[j] = std::clamp(v[j], -vmax, vmax);
+                x[j] += v[j];
+                if (x[j] < var.range.first || x[j] > var.range.second) { // 벽에 닿으면 그 축의 속도를 없앤다
+                    x[j] = std::clamp(x[j], var.range.first, var.range.second);
+                    v[j] = 0.0;
+                }
+            }
+            swarm[k].vars = x;
+        }
+        evaluateAll(swarm);
+        for (std::size_t k = 0; k < swarm.size(); ++k)
+            if (better(swarm[k], personal[k])) personal[k] = swarm[k];
+    }
+
+    void ParticleSwarm::inject(const Harmony& h) {
+        StepSolver::inject(h);
+        if (personal.empty()) return;
+        auto worst = std::max_element(personal.begin(), personal.end(),
+                                      [this](const Harmony& a, const Harmony& b) { return better(a, b); });
+        if (better(h, *worst)) *worst = h;
+    }
+
+    // ---- CMA-ES ----
+
+    CMAES::CMAES(const HSProblem& prob, const HSParams& params, unsigned int seed)
+            : StepSolver(prob, params, seed, "CMA-ES"), n(prob.variables.size()) {
+        const double dn = static_cast<double>(n);
+        lambda = params.PopSize ? std::max(4u, params.PopSize)
+                                : 4 + static_cast<std::size_t>(3.0 * std::log(dn));
+        mu = lambda / 2;
+        separable = n > 100;
+        weights.resize(mu);
+        for (std::size_t i = 0; i < mu; ++i)
+            weights[i] = std::log(static_cast<double>(mu) + 0.5) - std::log(static_cast<double>(i) + 1.0);
+        const double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+        double sq = 0.0;
+        for (auto& w : weights) {
+            w /= sum;
+            sq += w * w;
+        }
+        mueff = 1.0 / sq;
+        cc = (4.0 + mueff / dn) / (dn + 4.0 + 2.0 * mueff / dn);
+        cs = (mueff + 2.0) / (dn + mueff + 5.0);
+        c1 = 2.0 / ((dn + 1.3) * (dn + 1.3) + mueff);
+        cmu = std::min(1.0 - c1, 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((dn + 2.0) * (dn + 2.0) + mueff));
+        if (separable) { // 대각 공분산은 더 빨리 배울 수 있다
+            c1 *= (dn + 2.0) / 3.0;
+            cmu = std::min(1.0 - c1, cmu * (dn + 2.0) / 3.0);
+        }
+        damps = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff - 1.0) / (dn + 1.0)) - 1.0) + cs;
+        chiN = std::sqrt(dn) * (1.0 - 1.0 / (4.0 * dn) + 1.0 / (21.0 * dn * dn));
+    }
+
+    std::vector<double> CMAES::normalize(const std::vector<double>& x) const {
+        std::vector<double> u(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double s = span(problem.variables[i]);
+            u[i] = s > 0.0 ? (x[i] - problem.variables[i].range.first) / s : 0.5;
+        }
+        return u;
+    }
+
+    void CMAES::restart(const std::vector<double>& center) {
+        mean = center;
+        sigma = 0.3;
+        pc.assign(n, 0.0);
+        ps.assign(n, 0.0);
+        D.assign(n, 1.0);
+        if (separable) {
+            C.assign(n, 1.0);
+        } else {
+            C.assign(n * n, 0.0);
+            B.assign(n * n, 0.0);
+            for (std::size_t i = 0; i < n; ++i) C[i * n + i] = B[i * n + i] = 1.0;
+        }
+        eigenAt = generation;
+    }
+
+    void CMAES::initialize() {
+        samples.resize(lambda);
+        offspring.resize(lambda);
+        restart(normalize(randomPoint()));
+    }
+
+    // 대칭 행렬 C = B diag(D^2) B^T (순환 Jacobi 회전)
+    void CMAES::decompose() {
+        std::vector<double> A = C;
+        for (std::size_t i = 0; i < n * n; ++i) B[i] = (i % (n + 1) == 0) ? 1.0 : 0.0;
+        for (int sweep = 0; sweep < 50; ++sweep) {
+            double off = 0.0;
+            for (std::size_t p = 0; p < n; ++p)
+                for (std::size_t q = p + 1; q < n; ++q) off += A[p * n + q] * A[p * n + q];
+            if (off < 1e-30) break;
+            for (std::size_t p = 0; p < n; ++p) {
+                for (std::size_t q = p + 1; q < n; ++q) {
+                    const double apq = A[p * n + q];
+                    if (std::abs(apq) < 1e-300) continue;
+                    const double theta = (A[q * n + q] - A[p * n + p]) / (2.0 * apq);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                    const double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+                    for (std::size_t k = 0; k < n; ++k) {
+                        const double akp = A[k * n + p], akq = A[k * n + q];
+                        A[k * n + p] = c * akp - s * akq;
+                        A[k * n + q] = s * akp + c * akq;
+                    }
+                    for (std::size_t k = 0; k < n; ++k) {
+                        const double apk = A[p * n + k], aqk = A[q * n + k];
+                        A[p * n + k] = c * apk - s * aqk;
+                        A[q * n + k] = s * apk + c * aqk;
+                    }
+                    for (std::size_t k = 0; k < n; ++k) {
+                        const double bkp = B[k * n + p], bkq = B[k * n + q];
+                        B[k * n + p] = c * bkp - s * bkq;
+                        B[k * n + q] = s * bkp + c * bkq;
+                    }
+                }
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) D[i] = std::sqrt(std::max(A[i * n + i], 1e-20));
+        eigenAt = generation;
+    }
+
+    void CMAES::step() {
+        if (!separable && static_cast<double>(generation - eigenAt) > lambda / ((c1 + cmu) * n * 10.0))
+            decompose();
+        if (separable)
+            for (std::size_t i = 0; i < n; ++i) D[i] = std::sqrt(C[i]);
+
+        std::vector<double> z(n);
+        for (std::size_t k = 0; k < lambda; ++k) {
+            for (auto& zi : z) zi = rng.normal();
+            auto& u = samples[k];
+            u.resize(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                double y = 0.0;
+                if (separable) y = D[i] * z[i];
+                else for (std::size_t j = 0; j < n; ++j) y += B[i * n + j] * D[j] * z[j];
+                u[i] = std::clamp(mean[i] + sigma * y, 0.0, 1.0);
+            }
+            auto& x = offspring[k].vars;
+            x.resize(n);
+            for (std::size_t i = 0; i < n; ++i)
+                x[i] = problem.variables[i].range.first + u[i] * span(problem.variables[i]);
+        }
+        evaluateAll(offspring);
+        ++generation;
+
+        std::vector<std::size_t> order(lambda);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [this](std::size_t a, std::size_t b) { return better(offspring[a], offspring[b]); });
+
+        // 가중 평균 이동 yw = sum w_i (u_i - m) / σ
+        std::vector<double> yw(n, 0.0);
+        for (std::size_t r = 0; r < mu; ++r)
+            for (std::size_t i = 0; i < n; ++i) yw[i] += weights[r] * (samples[order[r]][i] - mean[i]) / sigma;
+        for (std::size_t i = 0; i < n; ++i) mean[i] += sigma * yw[i];
+
+        // C^{-1/2} yw
+        std::vector<double> white(n);
+        if (separable) {
+            for (std::size_t i = 0; i < n; ++i) white[i] = yw[i] / D[i];
+        } else {
+            std::vector<double> t(n, 0.0);
+            for (std::size_t j = 0; j < n; ++j) {
+                for (std::size_t i = 0; i < n; ++i) t[j] += B[i * n + j] * yw[i];
+                t[j] /= D[j];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                white[i] = 0.0;
+                for (std::size_t j = 0; j < n; ++j) white[i] += B[i * n + j] * t[j];
+            }
+        }
+        double psNorm = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            ps[i] = (1.0 - cs) * ps[i] + std::sqrt(cs * (2.0 - cs) * mueff) * white[i];
+            psNorm += ps[i] * ps[i];
+        }
+        psNorm = std::sqrt(psNorm);
+        const double decay = 1.0 - std::pow(1.0 - cs, 2.0 * static_cast<double>(generation));
+        const bool hsig = psNorm / std::sqrt(std::max(decay, 1e-300)) / chiN < 1.4 + 2.0 / (static_cast<double>(n) + 1.0);
+        for (std::size_t i = 0; i < n; ++i)
+            pc[i] = (1.0 - cc) * pc[i] + (hsig ? std::sqrt(cc * (2.0 - cc) * mueff) : 0.0) * yw[i];
+
+        const double keep = 1.0 - c1 - cmu + (hsig ? 0.0 : c1 * cc * (2.0 - cc));
+        if (separable) {
+            for (std::size_t i = 0; i < n; ++i) {
+                double rankMu = 0.0;
+                for (std::size_t r = 0; r < mu; ++r) {
+                    const double y = (samples[order[r]][i] - (mean[i] - sigma * yw[i])) / sigma;
+                    rankMu += weights[r] * y * y;
+                }
+                C[i] = keep * C[i] + c1 * pc[i] * pc[i] + cmu * rankMu;
+            }
+        } else {
+            std::vector<std::vector<double>> ys(mu, std::vector<double>(n));
+            for (std::size_t r = 0; r < mu; ++r)
+                for (std::size_t i = 0; i < n; ++i)
+                    ys[r][i] = (samples[order[r]][i] - (mean[i] - sigma * yw[i])) / sigma;
+            for (std::size_t i = 0; i < n; ++i) {
+                for (std::size_t j = 0; j <= i; ++j) {
+                    double rankMu = 0.0;
+                    for (std::size_t r = 0; r < mu; ++r) rankMu += weights[r] * ys[r][i] * ys[r][j];
+                    const double c = keep * C[i * n + j] + c1 * pc[i] * pc[j] + cmu * rankMu;
+                    C[i * n + j] = C[j * n + i] = c;
+                }
+            }
+        }
+
+        sigma *= std::exp(std::min(1.0, (cs / damps) * (psNorm / chiN - 1.0)));
+        const double axis = *std::max_element(D.begin(), D.end());
+        if (!std::isfinite(sigma) || sigma * axis < 1e-12 || sigma > 1e3)
+            restart(normalize(randomPoint()));
+    }
+
+    void CMAES::inject(const Harmony& h) {
+        if (initialized && better(h, bestSoFar)) mean = normalize(h.vars);
+        StepSolver::inject(h);
+    }
+
+    // ---- 패턴 탐색 ----
+
+    PatternSearch::PatternSearch(const HSProblem& prob, const HSParams& params, unsigned int seed)
+            : StepSolver(prob, params, seed, "Pattern") {}
+
+    void PatternSearch::restart() {
+        std::vector<Harmony> start(1);
+        start[0].vars = randomPoint();
+        evaluateAll(start);
+        center = start[0];
+        steps.resize(problem.variables.size());
+        for (std::size_t i = 0; i < steps.size(); ++i) {
+            const auto& var = problem.variables[i];
+            steps[i] = var.isInt ? std::max(1.0, std::round(0.25 * span(var))) : 0.25 * span(var);
+        }
+    }
+
+    void PatternSearch::initialize() { restart(); }
+
+    void PatternSearch::step() {
+        const std::size_t n = problem.variables.size();
+        polls.clear();
+        for (std::size_t i = 0; i < n; ++i) {
+            if (steps[i] <= 0.0) continue;
+            for (double sign : {1.0, -1.0}) {
+                const auto& var = problem.variables[i];
+                const double x = center.vars[i] + sign * steps[i];
+                if (x < var.range.first || x > var.range.second) continue;
+                polls.push_back(center);
+                polls.back().vars[i] = x;
+            }
+        }
+        if (!polls.empty()) evaluateAll(polls);
+
+        const Harmony* winner = nullptr;
+        for (const auto& p : polls)
+            if (better(p, winner ? *winner : center)) winner = &p;
+        if (winner) {
+            center = *winner;
+            return;
+        }
+
+        bool alive = false;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& var = problem.variables[i];
+            if (var.isInt) steps[i] = steps[i] > 1.0 ? std::floor(steps[i] / 2.0) : 0.0;
+            else steps[i] = steps[i] / 2.0 < 1e-9 * span(var) ? 0.0 : steps[i] / 2.0;
+            alive = alive || steps[i] > 0.0;
+        }
+        if (!alive) restart();
+    }
+
+    void PatternSearch::inject(const Harmony& h) {
+        if (initialized && better(h, center)) center = h;
+        StepSolver::inject(h);
+    }
+
+}
@@ -0,0 +1,87 @@
+#ifndef HSL_ENGINES_
+#define HSL_ENGINES_
+
+#include <vector>
+#include <cstddef>
+#include "solver.h"
+
+namespace hsl {
+
+    // 차분 진화 (DE/rand/1/bin, F = 0.5, CR = 0.9). 세대마다 시도 해 NP개를 한 번에 평가하고,
+    // 시도 해가 부모보다 나쁘지 않으면 교체한다. NP = PopSize (0: 변수 수*10, 20..100)
+    class DifferentialEvolution : public StepSolver {
+    public:
+        DifferentialEvolution(const HSProblem& prob, const HSParams& params, unsigned int seed);
+        void inject(const Harmony& h) override;
+
+    private:
+        std::vector<Harmony> population, trials;
+
+        void initialize() override;
+        void step() override;
+    };
+
+    // 입자 군집 최적화 (관성 가중치 0.7298, c1 = c2 = 1.49618, 속도는 범위의 20%로 제한).
+    // 전역 최적은 엔진의 최적 해(incumbent)라서 포트폴리오에서 받은 해도 곧바로 군집을 끌어당긴다.
+    // 입자 수 = PopSize (0: 40)
+    class ParticleSwarm : public StepSolver {
+    public:
+        ParticleSwarm(const HSProblem& prob, const HSParams& params, unsigned int seed);
+        void inject(const Harmony& h) override;
+
+    private:
+        std::vector<std::vector<double>> position, velocity; // 범위 안의 연속 좌표 (평가 시 int 변수는 반올림)
+        std::vector<Harmony> swarm, personal;
+
+        void initialize() override;
+        void step() override;
+    };
+
+    // CMA-ES ((mu/mu_w, lambda), lambda = PopSize (0: 4 + 3 ln n)). 변수를 범위로 [0,1]에 옮긴 공간에서 돌고,
+    // 범위 밖 표본은 잘라낸 점으로 갱신한다. 변수가 100개를 넘으면 공분산을 대각으로만 둔다(sep-CMA).
+    // 단계 크기가 무너지면(σ * 최대 축 < 1e-12) 임의의 점에서 다시 시작한다
+    class CMAES : public StepSolver {
+    public:
+        CMAES(const HSProblem& prob, const HSParams& params, unsigned int seed);
+        void inject(const Harmony& h) override;
+
+    private:
+        std::size_t n, lambda, mu;
+        bool separable;
+        std::vector<double> weights;
+        double mueff, cc, cs, c1, cmu, damps, chiN;
+        std::vector<double> mean, pc, ps;
+        std::vector<double> C, B, D;    // 공분산(n*n, 대각이면 n), 고유 벡터(n*n), 고유값의 제곱근
+        double sigma = 0.3;
+        std::uint64_t generation = 0, eigenAt = 0;
+        std::vector<std::vector<double>> samples; // 이번 세대의 정규화 좌표
+        std::vector<Harmony> offspring;
+
+        void initialize() override;
+        void step() override;
+        void restart(const std::vector<double>& center);
+        void decompose();
+        [[nodiscard]] std::vector<double> normalize(const std::vector<double>& x) const;
+    };
+
+    // 좌표 패턴 탐색 (compass search). 현재 점에서 변수마다 ±step을 한꺼번에 평가해 나아지면 옮기고,
+    // 아니면 step을 반으로 줄인다. 시작 step은 범위의 1/4(int 변수는 1 이상)이고,
+    // 모든 step이 바닥(범위*1e-9, int는 1 미만)에 닿으면 임의의 점에서 다시 시작한다
+    class PatternSearch : public StepSolver {
+    public:
+        PatternSearch(const HSProblem& prob, const HSParams& params, unsigned int seed);
+        void inject(const Harmony& h) override;
+
+    private:
+        Harmony center;
+        std::vector<double> steps;
+        std::vector<Harmony> polls;
+
+        void initialize() override;
+        void step() override;
+        void restart();
+    };
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include <cmath>
+#include <algorithm>
+#include "evalcache.h"
+
+namespace hsl {
+
+    EvalCache::EvalCache(const std::vector<Variable>& variables, std::size_t capacity)
+            : dim(variables.size()), cap(std::max<std::size_t>(capacity, 1)), key(variables) {
+        keys.resize(cap * dim);
+        values.resize(cap);
+        violations.resize(cap);
+        hashes.resize(cap);
+        referenced.resize(cap, 0);
+
+        // 적재율 50% 이하 유지
+        std::size_t slots = 16;
+        while (slots < cap * 2) slots <<= 1;
+        table.assign(slots, -1);
+        mask = slots - 1;
+        scratch.resize(dim);
+    }
+
+    std::size_t EvalCache::autoCapacity(const HSProblem& prob) {
+        constexpr double maxDomain = 1e6;        // 이보다 큰 정의역은 재방문이 드물어 캐시 이득이 적다
+        constexpr std::size_t maxEntries = 1 << 16;
+        if (prob.variables.empty() || prob.stochastic) return 0;
+
+        double domain = 1.0;
+        for (const auto& v : prob.variables) {
+            if (!v.isInt) return 0;
+            domain *= std::floor(v.range.second) - std::ceil(v.range.first) + 1.0;
+            if (domain > maxDomain) return 0;
+        }
+        return std::min<std::size_t>(static_cast<std::size_t>(domain), maxEntries);
+    }
+
+    void EvalCache::makeKey(const std::vector<double>& x) {
+        scratchHash = key.make(x, scratch.data());
+    }
+
+    bool EvalCache::sameKey(std::size_t entry) const {
+        return hashes[entry] == scratchHash &&
+               std::equal(scratch.begin(), scratch.end(), keys.begin() + static_cast<std::ptrdiff_t>(entry * dim));
+    }
+
+    bool EvalCache::lookup(const std::vector<double>& x, double& value, double& violation) {
+        makeKey(x);
+        for (std::size_t pos = scratchHash & mask; table[pos] >= 0; pos = (pos + 1) & mask) {
+            auto e = static_cast<std::size_t>(table[pos]);
+            if (sameKey(e)) {
+                referenced[e] = 1;
+                value = values[e];
+                violation = violations[e];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void EvalCache::insert(const std::vector<double>& x, double value, double violation) {
+        makeKey(x);
+        std::size_t e = (used < cap) ? used++ : evictOne();
+        std::copy(scratch.begin(), scratch.end(), keys.begin() + static_cast<std::ptrdiff_t>(e * dim));
+        values[e] = value;
+        violations[e] = violation;
+        hashes[e] = scratchHash;
+        referenced[e] = 0;
+
+        std::size_t pos = scratchHash & mask;
+        while (table[pos] >= 0) pos = (pos + 1) & mask;
+        table[pos] = static_cast<std::int32_t>(e);
+    }
+
+    // CLOCK: 최근 적중한 항목은 한 바퀴 유예
+    std::size_t EvalCache::evictOne() {
+        while (referenced[hand]) {
+            referenced[hand] = 0;
+            hand = (hand + 1) % cap;
+        }
+        std::size_t victim = hand;
+        hand = (hand + 1) % cap;
+        unlink(victim);
+        return victim;
+    }
+
+    // 선형 탐사 테이블에서 항목 제거 (후방 이동 삭제, 묘비 없음)
+    void EvalCache::unlink(std::size_t entry) {
+        std::size_t i = hashes[entry] & mask;
+        while (table[i] != static_cast<std::int32_t>(entry)) i = (i + 1) & mask;
+
+        for (std::size_t j = (i + 1) & mask; table[j] >= 0; j = (j + 1) & mask) {
+            std::size_t home = hashes[static_cast<std::size_t>(table[j])] & mask;
+            bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+            if (movable) {
+                table[i] = table[j];
+                i = j;
+            }
+        }
+        table[i] = -1;
+    }
+
+}
@@ -0,0 +1,56 @@
+#ifndef HSL_EVALCACHE_
+#define HSL_EVALCACHE_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "harmonykey.h"
+
+namespace hsl {
+
+    // 후보 벡터 -> (평가값, 제약 위반 정도) 캐시 (크기 제한, CLOCK 교체).
+    // 칸 없는 HarmonyKey(any 변수는 비트 패턴 그대로)를 키로 사용하므로 '정확히 같은 후보'만 적중한다.
+    class EvalCache {
+    public:
+        EvalCache(const std::vector<Variable>& variables, std::size_t capacity);
+
+        // 적중 시 value, violation을 채우고 true
+        bool lookup(const std::vector<double>& x, double& value, double& violation);
+        // lookup이 실패한 x에 대해서만 호출 (중복 키 검사는 하지 않음)
+        void insert(const std::vector<double>& x, double value, double violation);
+
+        [[nodiscard]] std::size_t capacity() const { return cap; }
+
+        // 모든 변수가 int이고 정의역 크기가 작으면 캐시 크기를, 아니면 0을 반환.
+        static std::size_t autoCapacity(const HSProblem& prob);
+
+    private:
+        std::size_t dim;
+        std::size_t cap;
+        HarmonyKey key;
+
+        // 항목 저장소 (항목 i의 키는 keys[i*dim .. i*dim+dim))
+        std::vector<std::int64_t> keys;
+        std::vector<double> values;
+        std::vector<double> violations;
+        std::vector<std::uint64_t> hashes;
+        std::vector<unsigned char> referenced;
+        std::size_t used = 0;
+        std::size_t hand = 0;
+
+        // 선형 탐사 해시 테이블 (항목 번호, 빈 칸은 -1)
+        std::vector<std::int32_t> table;
+        std::size_t mask;
+
+        std::vector<std::int64_t> scratch; // 마지막으로 계산한 키
+        std::uint64_t scratchHash = 0;
+
+        void makeKey(const std::vector<double>& x);
+        [[nodiscard]] bool sameKey(std::size_t entry) const;
+        std::size_t evictOne();
+        void unlink(std::size_t entry);
+    };
+
+}
+
+#endif
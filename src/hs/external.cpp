@@ -0,0 +1,287 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <algorithm>
+#include "external.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+namespace hsl {
+
+    namespace {
+        constexpr char handshakeMagic[8] = {'H', 'S', 'L', 'X', 'E', 'V', '0', '1'};
+        constexpr std::size_t responseSize = sizeof(std::uint64_t) + sizeof(double);
+        constexpr int maxSilentStarts = 3; // 응답 없이 이만큼 연달아 끝나면 명령 자체가 잘못된 것으로 본다
+        constexpr double startupGrace = 10.0; // 시작 확인(handshake 응답)까지의 최소 시간 한도 (초)
+
+        template<typename T>
+        void append(std::string& buffer, const T& v) {
+            buffer.append(reinterpret_cast<const char*>(&v), sizeof(T));
+        }
+    }
+
+    ExternalEvaluator::ExternalEvaluator(std::string command, std::size_t dimension, unsigned int workers,
+                                         unsigned int inFlight, double timeout)
+            : command(std::move(command)), dimension(dimension), inFlight(std::max(1u, inFlight)), timeout(timeout) {
+#ifdef _WIN32
+        throw std::runtime_error("External objectives are not supported on Windows yet");
+#else
+        if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+        this->workers.resize(workers);
+        std::signal(SIGPIPE, SIG_IGN); // 작업자가 죽은 파이프에 쓰면 write가 EPIPE로 실패하도록
+#endif
+    }
+
+#ifdef _WIN32
+
+    ExternalEvaluator::~ExternalEvaluator() = default;
+    void ExternalEvaluator::evaluate(const std::vector<std::vector<double>>&, const std::vector<std::uint64_t>&,
+                                     std::vector<double>&) {}
+    void ExternalEvaluator::spawn(Worker&) {}
+    void ExternalEvaluator::shutdown(Worker&, bool) {}
+    void ExternalEvaluator::fail(Worker&, bool, std::deque<Request>&, std::vector<double>&, std::size_t&) {}
+
+#else
+
+    ExternalEvaluator::~ExternalEvaluator() {
+        // stdin을 닫으면 작업자는 EOF를 보고 끝나야 한다. 잠시 기다린 뒤 남은 것은 강제 종료
+        for (auto& w : workers) {
+            if (w.input >= 0) close(w.input);
+            w.input = -1;
+        }
+        auto deadline = Clock::now() + std::chrono::milliseconds(500);
+        for (auto& w : workers) {
+            while (w.pid > 0 && Clock::now() < deadline) {
+                if (waitpid(w.pid, nullptr, WNOHANG) != 0) w.pid = -1;
+                else std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            shutdown(w, true);
+        }
+    }
+
+    void ExternalEvaluator::spawn(Worker& w) {
+        int toChild[2], fromChild[2];
+        if (pipe(toChild) != 0) throw std::runtime_error("Cannot create a pipe for the external objective");
+        if (pipe(fromChild) != 0) {
+            close(toChild[0]);
+            close(toChild[1]);
+            throw std::runtime_error("Cannot create a pipe for the external objective");
+        }
+        // 다른 작업자가 이 파이프를 물려받지 않도록 (dup2로 옮긴 0/1번은 exec 후에도 남는다)
+        for (int fd : {toChild[0], toChild[1], fromChild[0], fromChild[1]}) fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+        const char* cmd = command.c_str();
+        pid_t pid = fork();
+        if (pid < 0) {
+            for (int fd : {toChild[0], toChild[1], fromChild[0], fromChild[1]}) close(fd);
+            throw std::runtime_error("Cannot start the external objective: " + std::string(std::strerror(errno)));
+        }
+        if (pid == 0) {
+            setpgid(0, 0); // sh가 띄운 자식까지 한 번에 죽일 수 있도록 프로세스 그룹을 따로 둔다
+            dup2(toChild[0], STDIN_FILENO);
+            dup2(fromChild[1], STDOUT_FILENO);
+            execl("/bin/sh", "sh", "-c", cmd, static_cast<char*>(nullptr));
+            _exit(127);
+        }
+
+        setpgid(pid, pid);
+        close(toChild[0]);
+        close(fromChild[1]);
+        w.pid = pid;
+        w.input = toChild[1];
+        w.output = fromChild[0];
+        fcntl(w.input, F_SETFL, fcntl(w.input, F_GETFL) | O_NONBLOCK);
+        fcntl(w.output, F_SETFL, fcntl(w.output, F_GETFL) | O_NONBLOCK);
+        w.sendBuffer.assign(handshakeMagic, sizeof(handshakeMagic));
+        append(w.sendBuffer, static_cast<std::uint32_t>(dimension));
+        w.sent = 0;
+        w.receiveBuffer.clear();
+        w.pending.clear();
+        w.ready = false;
+        w.answered = false;
+    }
+
+    void ExternalEvaluator::shutdown(Worker& w, bool force) {
+        if (w.input >= 0) close(w.input);
+        if (w.output >= 0) close(w.output);
+        w.input = w.output = -1;
+        if (w.pid > 0) {
+            if (force) kill(-w.pid, SIGKILL);
+            waitpid(w.pid, nullptr, 0);
+        }
+        w.pid = -1;
+    }
+
+    // 작업자를 정리하고 보낸 요청을 처리한다. 가장 오래된 요청이 원인일 가능성이 크므로 그것만 실패(시간 초과) 또는
+    // 재시도 횟수 차감(비정상 종료) 대상이고, 나머지는 대기열 앞에 그대로 돌려놓는다
+    void ExternalEvaluator::fail(Worker& w, bool timedOut, std::deque<Request>& queue, std::vector<double>& values,
+                                 std::size_t& remaining) {
+        if (timedOut) ++stats.timeouts;
+        else ++stats.crashes;
+        shutdown(w, true);
+
+        for (auto it = w.pending.rbegin(); it != w.pending.rend(); ++it) {
+            auto found = outstanding.find(*it);
+            Request r = found->second;
+            outstanding.erase(found);
+            if (*it == w.pending.front() && (timedOut || ++r.attempts > 1)) {
+                values[r.index] = std::numeric_limits<double>::quiet_NaN();
+                ++stats.failures;
+                --remaining;
+            } else {
+                queue.push_front(r);
+            }
+        }
+        w.pending.clear();
+        w.sendBuffer.clear();
+        w.sent = 0;
+        w.receiveBuffer.clear();
+
+        if (w.answered) w.silentStarts = 0;
+        else if (++w.silentStarts >= maxSilentStarts)
+            throw std::runtime_error("External objective \"" + command + "\" exited " +
+                                     std::to_string(maxSilentStarts) + " times without answering a request");
+    }
+
+    void ExternalEvaluator::evaluate(const std::vector<std::vector<double>>& points,
+                                     const std::vector<std::uint64_t>& seeds, std::vector<double>& values) {
+        values.assign(points.size(), std::numeric_limits<double>::quiet_NaN());
+        std::deque<Request> queue;
+        for (std::size_t k = 0; k < points.size(); ++k) queue.push_back({k});
+        std::size_t remaining = points.size();
+        auto limit = [this](const Worker& w) { return w.ready ? timeout : std::max(timeout, startupGrace); };
+
+        std::vector<pollfd> fds;
+        std::vector<std::size_t> owners;
+        char chunk[4096];
+
+        while (remaining > 0) {
+            auto now = Clock::now();
+
+            // 1. 작업자마다 inFlight개까지 요청을 채워 보낸다
+            for (auto& w : workers) {
+                if (queue.empty()) break;
+                if (w.pid < 0) spawn(w);
+                while (w.pending.size() < inFlight && !queue.empty()) {
+                    Request r = queue.front();
+                    queue.pop_front();
+                    const std::uint64_t id = nextId++;
+                    if (w.pending.empty()) w.lastProgress = now;
+                    append(w.sendBuffer, id);
+                    append(w.sendBuffer, seeds[r.index]);
+                    for (double x : points[r.index]) append(w.sendBuffer, x);
+                    w.pending.push_back(id);
+                    outstanding.emplace(id, r);
+                }
+            }
+
+            // 2. 쓸 것이 남은 stdin과 답을 기다리는 stdout을 기다린다 (가장 가까운 시간 초과까지)
+            fds.clear();
+            owners.clear();
+            int wait = -1;
+            for (std::size_t i = 0; i < workers.size(); ++i) {
+                auto& w = workers[i];
+                if (w.pid < 0 || w.pending.empty()) continue;
+                fds.push_back({w.output, POLLIN, 0});
+                owners.push_back(i);
+                if (w.sent < w.sendBuffer.size()) {
+                    fds.push_back({w.input, POLLOUT, 0});
+                    owners.push_back(i);
+                }
+                if (timeout > 0.0) {
+                    auto left = std::chrono::duration<double>(limit(w)) - (now - w.lastProgress);
+                    int ms = std::max(0, static_cast<int>(std::ceil(std::chrono::duration<double, std::milli>(left).count())));
+                    wait = wait < 0 ? ms : std::min(wait, ms);
+                }
+            }
+            if (poll(fds.data(), fds.size(), wait) < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("External objective: poll failed: " + std::string(std::strerror(errno)));
+            }
+
+            // 3. 쓰기/읽기. 작업자가 끝났으면(EOF, EPIPE) 정리하고 요청을 돌려놓는다
+            now = Clock::now();
+            for (std::size_t j = 0; j < fds.size(); ++j) {
+                auto& w = workers[owners[j]];
+                if (w.pid < 0 || fds[j].revents == 0) continue;
+
+                if (fds[j].fd == w.input) {
+                    ssize_t n = write(w.input, w.sendBuffer.data() + w.sent, w.sendBuffer.size() - w.sent);
+                    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                        fail(w, false, queue, values, remaining);
+                        continue;
+                    }
+                    if (n > 0) w.sent += static_cast<std::size_t>(n);
+                    if (w.sent == w.sendBuffer.size()) {
+                        w.sendBuffer.clear();
+                        w.sent = 0;
+                    }
+                    continue;
+                }
+
+                bool closed = false;
+                for (;;) {
+                    ssize_t n = read(w.output, chunk, sizeof(chunk));
+                    if (n > 0) {
+                        w.receiveBuffer.append(chunk, static_cast<std::size_t>(n));
+                        continue;
+                    }
+                    if (n < 0 && errno == EINTR) continue;
+                    closed = n == 0 || errno != EAGAIN;
+                    break;
+                }
+
+                std::size_t used = 0;
+                if (!w.ready && w.receiveBuffer.size() >= sizeof(handshakeMagic)) {
+                    // 시작 완료. 이후로는 평가 시간만 잰다
+                    if (w.receiveBuffer.compare(0, sizeof(handshakeMagic), handshakeMagic, sizeof(handshakeMagic)) != 0)
+                        throw std::runtime_error("External objective \"" + command + "\" did not answer the HSLXEV01 handshake");
+                    used = sizeof(handshakeMagic);
+                    w.ready = true;
+                    w.lastProgress = now;
+                }
+                for (; w.ready && w.receiveBuffer.size() - used >= responseSize; used += responseSize) {
+                    std::uint64_t id;
+                    double value;
+                    std::memcpy(&id, w.receiveBuffer.data() + used, sizeof(id));
+                    std::memcpy(&value, w.receiveBuffer.data() + used + sizeof(id), sizeof(value));
+                    auto mine = std::find(w.pending.begin(), w.pending.end(), id);
+                    if (mine == w.pending.end()) continue; // 이 작업자에게 보낸 적 없는 번호는 무시
+                    w.pending.erase(mine);
+                    auto found = outstanding.find(id);
+                    values[found->second.index] = value;
+                    outstanding.erase(found);
+                    ++stats.evaluations;
+                    if (std::isnan(value)) ++stats.failures;
+                    --remaining;
+                    w.lastProgress = now;
+                    w.answered = true;
+                }
+                w.receiveBuffer.erase(0, used);
+                if (closed) fail(w, false, queue, values, remaining);
+            }
+
+            // 4. 가장 오래된 요청이 timeout초 동안 답이 없는 작업자
+            if (timeout > 0.0) {
+                for (auto& w : workers) {
+                    if (w.pid > 0 && !w.pending.empty() &&
+                        std::chrono::duration<double>(now - w.lastProgress).count() >= limit(w))
+                        fail(w, true, queue, values, remaining);
+                }
+            }
+        }
+    }
+
+#endif
+
+}
@@ -0,0 +1,86 @@
+#ifndef HSL_EXTERNAL_
+#define HSL_EXTERNAL_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <unordered_map>
+
+namespace hsl {
+
+    // [OBJ] ... external "명령"의 평가기. 명령을 /bin/sh -c로 workers개 띄워 두고 표준 입출력 파이프로 후보를 보낸다.
+    //
+    // 프로토콜 (모두 little-endian, 길이 고정):
+    //   시작 시 한 번  HS -> 작업자 : "HSLXEV01" (8바이트) + u32 변수 수 n
+    //                 작업자 -> HS : "HSLXEV01" (준비 완료)
+    //   요청          HS -> 작업자 : u64 요청 번호 + u64 난수 시드 + f64 * n (변수 순서는 [VAR] 전개 순서)
+    //   응답          작업자 -> HS : u64 요청 번호 + f64 목적 값 (NaN: 평가 실패)
+    // 작업자마다 요청을 inFlight개까지 미리 보내 두며, 응답은 요청 번호로 맞추므로 순서가 바뀌어도 된다.
+    // 가장 오래된 요청이 timeout초(시작 확인 전에는 10초 이상) 안에 답이 없으면 작업자를 죽이고 그 요청은 실패(NaN)로, 나머지는 다른 작업자에 다시 보낸다.
+    // 작업자가 죽으면(EOF, 쓰기 실패) 다시 띄우고 가장 오래된 요청은 한 번만 재시도한다.
+    // 한 스레드에서만 사용 (HSProblem::parallelSafe = false)
+    class ExternalEvaluator {
+    public:
+        struct Counters {
+            std::uint64_t evaluations = 0; // 답을 받은 요청 수
+            std::uint64_t failures = 0;    // NaN으로 처리한 요청 수 (시간 초과 포함)
+            std::uint64_t timeouts = 0;
+            std::uint64_t crashes = 0;     // 작업자가 중간에 끝난 횟수
+        };
+
+        ExternalEvaluator(std::string command, std::size_t dimension, unsigned int workers,
+                          unsigned int inFlight, double timeout);
+        ~ExternalEvaluator();
+        ExternalEvaluator(const ExternalEvaluator&) = delete;
+        ExternalEvaluator& operator=(const ExternalEvaluator&) = delete;
+
+        // values[k] = points[k]의 목적 값. 모든 요청이 끝날(답, 실패, 시간 초과) 때까지 돌아오지 않는다
+        void evaluate(const std::vector<std::vector<double>>& points, const std::vector<std::uint64_t>& seeds,
+                      std::vector<double>& values);
+        // 한 번에 보낼 수 있는 요청 수 (작업자 수 * inFlight)
+        [[nodiscard]] std::size_t capacity() const { return workers.size() * inFlight; }
+        [[nodiscard]] std::size_t workerCount() const { return workers.size(); }
+        [[nodiscard]] const Counters& counters() const { return stats; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Worker {
+            int pid = -1;
+            int input = -1;                 // 작업자 stdin (쓰기 쪽)
+            int output = -1;                // 작업자 stdout (읽기 쪽)
+            std::string sendBuffer;         // 아직 못 쓴 바이트 (sent부터)
+            std::size_t sent = 0;
+            std::string receiveBuffer;
+            std::deque<std::uint64_t> pending; // 보낸 순서대로의 요청 번호
+            Clock::time_point lastProgress;
+            bool ready = false;             // 시작 확인을 받았는지
+            bool answered = false;          // 이번에 띄운 뒤 요청에 한 번이라도 답했는지
+            int silentStarts = 0;           // 응답 없이 연달아 끝난 횟수
+        };
+        struct Request {
+            std::size_t index;              // points 안의 위치
+            int attempts = 0;
+        };
+
+        std::string command;
+        std::size_t dimension;
+        unsigned int inFlight;
+        double timeout;
+        std::vector<Worker> workers;
+        std::unordered_map<std::uint64_t, Request> outstanding; // 요청 번호 -> 요청
+        std::uint64_t nextId = 0;
+        Counters stats;
+
+        void spawn(Worker& w);
+        void shutdown(Worker& w, bool force);
+        void fail(Worker& w, bool timedOut, std::deque<Request>& queue, std::vector<double>& values,
+                  std::size_t& remaining);
+    };
+
+}
+
+#endif
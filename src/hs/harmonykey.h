@@ -0,0 +1,79 @@
+#ifndef HSL_HARMONYKEY_
+#define HSL_HARMONYKEY_
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "../interpreter/evaluator.h"
+
+namespace hsl {
+
+    // 해 벡터 -> 정수 키와 그 해시. EvalCache와 HarmonyIndex가 같은 규칙을 쓰도록 한 곳에 둔다.
+    // int 변수는 반올림한 정수, any 변수는 tolerance가 0이면 비트 패턴 그대로(-0.0은 0.0으로),
+    // 아니면 범위*tolerance 크기의 칸 번호를 키로 쓴다.
+    class HarmonyKey {
+    public:
+        explicit HarmonyKey(const std::vector<Variable>& variables, double tolerance = 0.0) {
+            for (const auto& v : variables) {
+                isInt.push_back(v.isInt ? 1 : 0);
+                lower.push_back(v.range.first);
+                cell.push_back(tolerance > 0.0 ? (v.range.second - v.range.first) * tolerance : 0.0);
+            }
+        }
+
+        [[nodiscard]] std::size_t size() const { return isInt.size(); }
+
+        // x의 키를 key[0 .. size())에 쓰고 해시를 돌려준다
+        std::uint64_t make(const std::vector<double>& x, std::int64_t* key) const {
+            std::uint64_t h = seed;
+            for (std::size_t i = 0; i < isInt.size(); ++i) {
+                std::int64_t k;
+                if (isInt[i]) {
+                    k = std::llround(x[i]);
+                } else if (cell[i] > 0.0) {
+                    k = static_cast<std::int64_t>(std::floor((x[i] - lower[i]) / cell[i]));
+                } else {
+                    double d = (x[i] == 0.0) ? 0.0 : x[i]; // -0.0 == 0.0
+                    std::memcpy(&k, &d, sizeof(k));
+                }
+                key[i] = k;
+                h = mix(h, k);
+            }
+            return finish(h);
+        }
+
+        // make가 돌려주는 것과 같은 해시
+        static std::uint64_t hash(const std::int64_t* key, std::size_t n) {
+            std::uint64_t h = seed;
+            for (std::size_t i = 0; i < n; ++i) h = mix(h, key[i]);
+            return finish(h);
+        }
+
+        // unordered_map<std::vector<std::int64_t>, ...>용
+        struct Hash {
+            std::size_t operator()(const std::vector<std::int64_t>& k) const {
+                return static_cast<std::size_t>(HarmonyKey::hash(k.data(), k.size()));
+            }
+        };
+
+    private:
+        static constexpr std::uint64_t seed = 0xCBF29CE484222325ull;
+
+        std::vector<unsigned char> isInt;
+        std::vector<double> lower;
+        std::vector<double> cell; // any 변수의 칸 크기 (0: 정확히 같은 값만)
+
+        static std::uint64_t mix(std::uint64_t h, std::int64_t k) {
+            return h ^ (static_cast<std::uint64_t>(k) + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2));
+        }
+        static std::uint64_t finish(std::uint64_t h) {
+            h ^= h >> 33; h *= 0xFF51AFD7ED558CCDull; h ^= h >> 33;
+            return h;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+#include "hmindex.h"
+
+namespace hsl {
+
+    HarmonyIndex::HarmonyIndex(const std::vector<Variable>& variables, double tolerance)
+            : key(variables, tolerance), scratch(variables.size()) {}
+
+    const std::vector<std::int64_t>& HarmonyIndex::makeKey(const std::vector<double>& x) const {
+        key.make(x, scratch.data());
+        return scratch;
+    }
+
+    void HarmonyIndex::clear() {
+        counts.clear();
+    }
+
+    void HarmonyIndex::add(const std::vector<double>& x) {
+        ++counts[makeKey(x)];
+    }
+
+    void HarmonyIndex::remove(const std::vector<double>& x) {
+        auto it = counts.find(makeKey(x));
+        if (it != counts.end() && --it->second == 0) counts.erase(it);
+    }
+
+    bool HarmonyIndex::contains(const std::vector<double>& x) const {
+        return counts.count(makeKey(x)) > 0;
+    }
+
+}
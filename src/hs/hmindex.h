@@ -0,0 +1,36 @@
+#ifndef HSL_HMINDEX_
+#define HSL_HMINDEX_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+#include "harmonykey.h"
+
+namespace hsl {
+
+    // HM 멤버의 해시 색인 (키 -> 그 키를 가진 멤버 수). 키 규칙은 HarmonyKey.
+    // 칸 단위이므로 tolerance > 0의 '근접 중복'은 같은 칸에 든 해끼리만 잡힌다.
+    class HarmonyIndex {
+    public:
+        HarmonyIndex(const std::vector<Variable>& variables, double tolerance);
+
+        void clear();
+        void add(const std::vector<double>& x);
+        void remove(const std::vector<double>& x);
+        // x와 같은 키의 멤버가 있는지
+        [[nodiscard]] bool contains(const std::vector<double>& x) const;
+        // 서로 다른 키의 수
+        [[nodiscard]] std::size_t distinct() const { return counts.size(); }
+
+    private:
+        HarmonyKey key;
+        std::unordered_map<std::vector<std::int64_t>, std::size_t, HarmonyKey::Hash> counts;
+        mutable std::vector<std::int64_t> scratch;
+
+        const std::vector<std::int64_t>& makeKey(const std::vector<double>& x) const;
+    };
+
+}
+
+#endif
@@ -3,166 +3,1392 @@
 #include <limits>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <cmath>
+#include <stdexcept>
 #include "hsalgorithm.h"
-#include "io.h"   // hsl::cout 정의 헤더 (GUI/CLI 출력 통합)
+#include "checkpoint.h"
+#include "io.h"   // out 정의 헤더 (GUI/CLI 출력 통합)
+#include "../utils/random.h"
+#include "../utils/threadpool.h"
+#include "../interpreter/compiler.h"
 
 namespace hsl {
 
     HarmonySearch::HarmonySearch(const HSProblem& prob, const HSParams& params, unsigned int seed)
-            : problem(prob), params(params) {
+            : problem(prob), params(params), out(params.Quiet ? silent : hsl::cout), seed(seed),
+              dedup(params.Dedup && !prob.stochastic), index(prob.variables, dedup ? params.DedupTol : 0.0) {
         rng.seed(seed);
+
+        long capacity = params.CacheSize;
+        if (capacity < 0) capacity = static_cast<long>(EvalCache::autoCapacity(problem));
+        if (capacity > 0 && !problem.stochastic)
+            cache = std::make_unique<EvalCache>(problem.variables, static_cast<std::size_t>(capacity));
+
+        if (params.Dedup && problem.stochastic)
+            out << "[WARN] Dedup disabled: the model calls rand/randn/randint, so re-evaluating a member can change its value"
+                << std::endl;
+
+        if (params.Stats) counterSet = std::make_unique<CounterSet>(problem.constraintVariables.size());
+
+        if (params.Surrogate) {
+            std::size_t size = params.SurrogateSize ? params.SurrogateSize
+                                                    : std::clamp<std::size_t>(problem.variables.size() * 5, 50, 500);
+            surrogate = std::make_unique<Surrogate>(problem.variables, size);
+            if (surrogate->unusable()) {
+                out << "[WARN] Surrogate disabled: " << problem.variables.size() << " variables need SurrogateSize >= "
+                    << problem.variables.size() + 2 << std::endl;
+                surrogate.reset();
+            }
+        }
+    }
+
+    // 후보 1개당 난수 스트림 1개. 평가 순서(스레드)와 무관하게 후보 번호로만 결정된다.
+    std::uint64_t HarmonySearch::nextStream() {
+        return deriveStream(seed, evalCount++);
+    }
+
+    // 제약 위반 등 HM에 들어갈 수 없는 해의 값
+    double HarmonySearch::invalidValue() const {
+        return problem.maximize ?
+            std::numeric_limits<double>::lowest() :
+            std::numeric_limits<double>::infinity();
+    }
+
+    // a가 b보다 나은 해인가 (제약 처리 방식에 따른 HM 내 순서)
+    bool HarmonySearch::precedes(const Harmony& a, const Harmony& b) const {
+        auto better = [this](double x, double y) { return problem.maximize ? x > y : x < y; };
+        switch (params.Constraints) {
+            case ConstraintMode::Static:
+            case ConstraintMode::Adaptive: {
+                double sign = problem.maximize ? -1.0 : 1.0;
+                return better(a.value + sign * penaltyWeight * a.violation,
+                              b.value + sign * penaltyWeight * b.violation);
+            }
+            case ConstraintMode::Epsilon:
+                if ((a.violation <= epsilon && b.violation <= epsilon) || a.violation == b.violation)
+                    return better(a.value, b.value);
+                return a.violation < b.violation;
+            default: // Reject, Deb
+                if (a.violation == 0.0 && b.violation == 0.0) return better(a.value, b.value);
+                return a.violation < b.violation;
+        }
+    }
+
+    // 위반 정도가 violation인 해의 순서를 정하는 데 목적 값이 필요한가
+    bool HarmonySearch::needsObjective(double violation) const {
+        if (violation == 0.0) return true;
+        switch (params.Constraints) {
+            case ConstraintMode::Static:
+            case ConstraintMode::Adaptive: return true;
+            case ConstraintMode::Epsilon: return violation <= epsilon;
+            default: return false;
+        }
+    }
+
+    // 위반 정도가 violation인 후보가 rival을 이기려면 넘어야 하는 목적 값. 목적 값과 무관하게 이기면 invalidValue()
+    double HarmonySearch::objectiveCutoff(double violation, const Harmony& rival) const {
+        switch (params.Constraints) {
+            case ConstraintMode::Static:
+            case ConstraintMode::Adaptive: {
+                double sign = problem.maximize ? -1.0 : 1.0;
+                return rival.value + sign * penaltyWeight * (rival.violation - violation);
+            }
+            case ConstraintMode::Epsilon:
+                return (rival.violation <= epsilon || rival.violation == violation) ? rival.value : invalidValue();
+            default:
+                return rival.violation == 0.0 ? rival.value : invalidValue();
+        }
+    }
+
+    std::size_t HarmonySearch::worstIndex() const {
+        auto it = std::max_element(HM.begin(), HM.end(),
+                                   [this](const Harmony& a, const Harmony& b) { return precedes(a, b); });
+        return static_cast<std::size_t>(it - HM.begin());
+    }
+
+    double HarmonySearch::worstValue() const {
+        return HM[worstIndex()].value;
+    }
+
+    // 해를 평가해 h.value, h.violation을 채운다.
+    // rival: 이 후보가 이겨야 하는 해 (보통 HM worst). 이길 수 없다고 판명되면 평가를 중단하고 aborted = true
+    // violationKnown: h.violation이 이미 계산되어 있음 (보정 단계를 거친 후보)
+    void HarmonySearch::evaluate(Harmony& h, std::uint64_t stream, const Harmony* rival, bool& aborted,
+                                 bool violationKnown) {
+        aborted = false;
+        if (!violationKnown) h.violation = violationOf(h.vars, stream);
+        if (h.violation > 0.0) ++statistics.infeasible;
+        else if (!statistics.firstFeasibleAt) statistics.firstFeasibleAt = evalCount;
+        if (counterSet) countCheck(h.vars, stream, h.violation);
+
+        if (!needsObjective(h.violation)) {
+            // 위반 정도만으로 순서가 정해지므로 목적 함수는 부르지 않는다
+            h.value = invalidValue();
+            return;
+        }
+
+        auto objStream = deriveStream(stream, 0);
+        double cutoff = rival ? objectiveCutoff(h.violation, *rival) : invalidValue();
+        bool predicted = false;
+        double prediction = 0.0;
+        if (rival && screenOut(h, stream, cutoff, predicted, prediction)) {
+            aborted = true; // 캐시에 남기지 않음
+            h.value = invalidValue();
+            return;
+        }
+
+        ++statistics.evaluations;
+        RunCounters* counters = tally();
+        ScopedTimer timer(counters ? &counters->objectiveNs : nullptr);
+        if (params.EarlyAbort && problem.objectiveBounded && cutoff != invalidValue()) {
+            if (!problem.objectiveBounded(h.vars, objStream, cutoff, h.value)) {
+                ++statistics.earlyAborts;
+                aborted = true;
+                h.value = invalidValue();
+                return;
+            }
+        } else {
+            h.value = problem.objectiveSeeded ? problem.objectiveSeeded(h.vars, objStream)
+                                              : problem.objective(h.vars); // 최소화를 부호 반전했다가 문제가 생김 → 그대로
+        }
+        if (std::isnan(h.value)) h.value = invalidValue(); // 평가 실패 (외부 평가기의 시간 초과 등)
+        else learn(h, predicted, prediction, cutoff);
+    }
+
+    // Surrogate: 예측한 목적 값이 cutoff를 넘지 못하면 평가를 생략한다 (SurrogateExplore 비율은 그래도 평가).
+    // 예측했으면 predicted = true. cutoff가 invalidValue()면 목적 값과 무관하게 이기므로 예측하지 않음.
+    // 탐색용 동전은 후보의 스트림에서 던진다 (rng를 쓰면 캐시 적중 여부에 따라 이후 즉흥 연주가 달라짐)
+    bool HarmonySearch::screenOut(const Harmony& h, std::uint64_t stream, double cutoff, bool& predicted,
+                                  double& prediction) {
+        predicted = false;
+        if (!surrogate || cutoff == invalidValue() || !surrogate->predict(h.vars, prediction)) return false;
+        predicted = true;
+        const bool promising = problem.maximize ? prediction > cutoff : prediction < cutoff;
+        if (promising) return false;
+        SplitMix64 coin{deriveStream(stream, 2)};
+        if (coin.uniform() < params.SurrogateExplore) return false;
+        ++statistics.surrogateSkipped;
+        return true;
+    }
+
+    // 실제 목적 값을 대리 모델 보관소에 넣고, 예측했던 후보면 cutoff를 넘는지에 대한 판정이 맞았는지 센다
+    void HarmonySearch::learn(const Harmony& h, bool predicted, double prediction, double cutoff) {
+        if (!surrogate) return;
+        if (predicted) {
+            auto beats = [&](double v) { return problem.maximize ? v > cutoff : v < cutoff; };
+            ++statistics.surrogateChecked;
+            if (beats(prediction) == beats(h.value)) ++statistics.surrogateAgreed;
+        }
+        feedSurrogate(h.vars, h.value);
+    }
+
+    // 보관소에 점 하나를 넣는다. 맞춤이 연달아 실패하면(평가한 점으로 모델을 세울 수 없음) 대리 모델을 끈다
+    void HarmonySearch::feedSurrogate(const std::vector<double>& x, double y) {
+        surrogate->add(x, y);
+        if (!surrogate->failed()) return;
+        out << "[WARN] Surrogate disabled: the model could not be fitted to the evaluated points" << std::endl;
+        surrogate.reset();
+    }
+
+    // 즉흥 연주로 만든 후보 평가. 이미 평가한 후보면 캐시 값을 그대로 사용 (제약 위반 결과 포함)
+    void HarmonySearch::evaluateCandidate(Harmony& h) {
+        auto stream = nextStream();
+        const bool repairing = !params.Repair.empty() && problem.constraintViolations;
+        if (repairing) repairCandidate(h, stream);
+
+        const Harmony* rival = HM.empty() ? nullptr : &HM[worstIndex()];
+        bool aborted = false;
+        if (!cache) {
+            evaluate(h, stream, rival, aborted, repairing);
+            return;
+        }
+
+        ++statistics.cacheLookups;
+        if (cache->lookup(h.vars, h.value, h.violation)) {
+            ++statistics.cacheHits;
+            return;
+        }
+        evaluate(h, stream, rival, aborted, repairing);
+        if (!aborted) cache->insert(h.vars, h.value, h.violation); // 중단된 결과는 cutoff에 따라 달라지므로 저장하지 않음
+    }
+
+    // 변수 하나를 기본 HS 규칙(HMCR, PAR, 변수별 대역폭)으로 다시 뽑는다
+    double HarmonySearch::resampleVariable(std::size_t i) {
+        const auto& var = problem.variables[i];
+        if (std::generate_canonical<double, 10>(rng) < params.HMCR) {
+            double x = HM[rng() % HM.size()].vars[i];
+            if (std::generate_canonical<double, 10>(rng) < params.PAR) x = pitchAdjust(i, x, bandwidth(i, 0.0));
+            return x;
+        }
+        if (var.isInt) {
+            std::uniform_int_distribution<int> idist(static_cast<int>(var.range.first), static_cast<int>(var.range.second));
+            return idist(rng);
+        }
+        std::uniform_real_distribution<double> rdist(var.range.first, var.range.second);
+        return rdist(rng);
+    }
+
+    // 위반한 후보를 params.Repair 단계 순서대로 보정한다. 위반 정도를 줄인 변경만 남기고 h.violation을 채운다.
+    // 보정된 후보가 HM에 들어가므로 이후 즉흥 연주도 실행 가능 영역에서 값을 가져오게 된다.
+    void HarmonySearch::repairCandidate(Harmony& h, std::uint64_t stream) {
+        h.violation = violationOf(h.vars, stream);
+        if (h.violation == 0.0) return;
+        ++statistics.repairAttempts;
+
+        std::vector<double> trial;
+        std::vector<int> involved; // 위반한 제약에 나타나는 변수
+        auto accept = [&] {
+            if (problem.repair) problem.repair(trial);
+            double v = violationOf(trial, stream);
+            if (v >= h.violation) return false;
+            h.vars = trial;
+            h.violation = v;
+            return true;
+        };
+        auto collectInvolved = [&] {
+            problem.constraintViolations(h.vars, stream, constraintScratch);
+            involved.clear();
+            for (std::size_t c = 0; c < constraintScratch.size(); ++c)
+                if (constraintScratch[c] > 0.0)
+                    involved.insert(involved.end(), problem.constraintVariables[c].begin(), problem.constraintVariables[c].end());
+            std::sort(involved.begin(), involved.end());
+            involved.erase(std::unique(involved.begin(), involved.end()), involved.end());
+        };
+
+        for (RepairStage stage : params.Repair) {
+            if (h.violation == 0.0) break;
+            switch (stage) {
+                case RepairStage::Clamp: {
+                    // 범위는 제약이 아니라 정의이므로 위반 정도와 무관하게 적용
+                    bool changed = false;
+                    for (std::size_t i = 0; i < h.vars.size(); ++i) {
+                        const auto& var = problem.variables[i];
+                        double x = std::clamp(h.vars[i], var.range.first, var.range.second);
+                        if (var.isInt) x = std::round(x);
+                        changed |= x != h.vars[i];
+                        h.vars[i] = x;
+                    }
+                    if (changed) h.violation = violationOf(h.vars, stream);
+                    break;
+                }
+                case RepairStage::Resample:
+                    for (int t = 0; t < params.RepairTries && h.violation > 0.0; ++t) {
+                        collectInvolved();
+                        trial = h.vars;
+                        for (int i : involved) trial[i] = resampleVariable(static_cast<std::size_t>(i));
+                        accept();
+                    }
+                    break;
+                case RepairStage::Greedy:
+                    for (int t = 0; t < params.RepairTries && h.violation > 0.0; ++t) {
+                        collectInvolved();
+                        bool moved = false;
+                        for (int i : involved) {
+                            const auto& var = problem.variables[i];
+                            double bw = bandwidth(i, 0.0);
+                            double step = var.isInt ? std::max(1.0, std::round(bw)) : bw;
+                            for (double dir : {1.0, -1.0}) {
+                                trial = h.vars;
+                                trial[i] = std::clamp(trial[i] + dir * step, var.range.first, var.range.second);
+                                if (trial[i] != h.vars[i] && accept()) {
+                                    moved = true;
+                                    break;
+                                }
+                            }
+                            if (h.violation == 0.0) break;
+                        }
+                        if (!moved) break;
+                    }
+                    break;
+            }
+        }
+        if (h.violation == 0.0) ++statistics.repairSuccesses;
+    }
+
+    // HM에서 목적 값 없이 들어온 해(초기화의 위반 해) 중 현재 방식에서 목적 값이 필요한 것을 평가
+    void HarmonySearch::completeObjectives() {
+        bool aborted = false;
+        for (auto& h : HM) {
+            if (h.violation > 0.0 && h.value == invalidValue() && needsObjective(h.violation))
+                evaluate(h, nextStream(), nullptr, aborted);
+        }
+    }
+
+    // 반복마다 제약 처리 상태 갱신
+    //  Epsilon : ε(t) = ε0 * (1 - t/Tc)^cp (t < Tc), 이후 0. Tc = MaxImp/5, cp = 5
+    //  Adaptive: 최적 해가 20회 연속 실행 가능하면 가중치 / 1.5, 20회 연속 위반이면 * 2
+    void HarmonySearch::updateConstraintHandling(unsigned int iter) {
+        if (params.Constraints == ConstraintMode::Epsilon) {
+            const double Tc = 0.2 * params.MaxImp;
+            epsilon = iter < Tc ? epsilon0 * std::pow(1.0 - iter / Tc, 5.0) : 0.0;
+        } else if (params.Constraints == ConstraintMode::Adaptive) {
+            bool feasible = best().violation == 0.0;
+            if (feasible != penaltyRunFeasible) {
+                penaltyRunFeasible = feasible;
+                penaltyRun = 0;
+            }
+            if (++penaltyRun >= 20) {
+                penaltyWeight = feasible ? penaltyWeight / 1.5 : penaltyWeight * 2.0;
+                penaltyRun = 0;
+            }
+        }
     }
 
-    // 해를 평가
-    double HarmonySearch::evaluate(const std::vector<double>& solution) {
-        double obj = problem.objective(solution);
-        double pen = problem.penalty(solution);
+    double HarmonySearch::violationOf(const std::vector<double>& solution, std::uint64_t stream) const {
+        RunCounters* counters = tally();
+        ScopedTimer timer(counters ? &counters->penaltyNs : nullptr);
+        if (problem.violationSeeded) return problem.violationSeeded(solution, deriveStream(stream, 1));
+        double pen = problem.penaltySeeded ? problem.penaltySeeded(solution, deriveStream(stream, 1))
+                                           : problem.penalty(solution);
+        return pen == 0.0 ? 0.0 : 1.0;
+    }
 
-        if (std::isinf(pen)) {
-            // 제약 위반은 무효 해로 간주
-            return problem.maximize ?
-                std::numeric_limits<double>::lowest() :
-                std::numeric_limits<double>::infinity();
+    // Stats: 제약을 판정한 후보 하나. 위반이면 어긴 [ST]마다 센다 (violationOf와 같은 스트림)
+    void HarmonySearch::countCheck(const std::vector<double>& solution, std::uint64_t stream, double violation) {
+        RunCounters& counters = *tally();
+        ++counters.checked;
+        if (violation == 0.0) {
+            ++counters.feasible;
+            return;
         }
-        return obj; // 최소화를 부호 반전했다가 문제가 생김 → 그대로 반환
+        if (!problem.constraintViolations) return;
+        ScopedTimer timer(&counters.penaltyNs);
+        problem.constraintViolations(solution, deriveStream(stream, 1), constraintScratch);
+        for (std::size_t i = 0; i < constraintScratch.size() && i < counters.rejections.size(); ++i)
+            if (constraintScratch[i] > 0.0) ++counters.rejections[i];
+    }
+
+    RunCounters HarmonySearch::counters() const {
+        return counterSet ? counterSet->collect() : RunCounters{};
     }
 
-    // 제약을 만족하는 해 생성
-    Harmony HarmonySearch::generateFeasibleSolution() {
-        std::uniform_real_distribution<double> dist01(0.0, 1.0);
+    // 초기 해 count개 생성.
+    // 라틴 하이퍼큐브 묶음으로 뽑고(각 변수 범위를 묶음 크기만큼 등분해 한 칸에 하나씩),
+    // 제약 검사/목적 평가는 스레드 풀에서 병렬로 하되 채택은 표본 순서대로 하므로 스레드 수와 무관하게 결정적이다.
+    // InitBudget개를 뽑아도 실행 가능 해가 모자라면 위반 정도가 가장 작은 해로 채우고 경고를 남긴다.
+    std::vector<Harmony> HarmonySearch::initialHarmonies(std::size_t count) {
+        const std::size_t n = problem.variables.size();
+        const std::size_t budget = params.InitBudget ? params.InitBudget
+                                                     : std::max<std::size_t>(count * 200, 10000);
+        ThreadPool& pool = ThreadPool::shared();
+        const std::size_t batch = std::max<std::size_t>(count, 4 * pool.concurrency());
+
+        std::vector<Harmony> feasible;
+        std::vector<std::pair<double, Harmony>> nearest; // (위반 정도, 해), 위반이 작은 순으로 최대 count개
+        std::vector<std::vector<double>> samples(batch, std::vector<double>(n));
+        std::vector<std::uint64_t> streams(batch);
+        std::vector<double> violations(batch), values(batch);
+        std::vector<std::size_t> perm(batch);
+        std::uniform_real_distribution<double> u01(0.0, 1.0);
+        std::size_t tried = 0;
+
+        while (feasible.size() < count && tried < budget) {
+            const std::size_t m = std::min(batch, budget - tried);
+
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto& var = problem.variables[i];
+                for (std::size_t k = 0; k < m; ++k) perm[k] = k;
+                std::shuffle(perm.begin(), perm.begin() + static_cast<std::ptrdiff_t>(m), rng);
+                for (std::size_t k = 0; k < m; ++k) {
+                    double u = (static_cast<double>(perm[k]) + u01(rng)) / static_cast<double>(m);
+                    if (var.isInt) {
+                        int lo = static_cast<int>(var.range.first);
+                        int hi = static_cast<int>(var.range.second);
+                        samples[k][i] = std::min<double>(hi, lo + std::floor(u * (hi - lo + 1)));
+                    } else {
+                        samples[k][i] = var.range.first + u * (var.range.second - var.range.first);
+                    }
+                }
+            }
+            const std::uint64_t firstCandidate = evalCount + 1;
+            for (std::size_t k = 0; k < m; ++k) streams[k] = nextStream();
+
+            auto check = [&](std::size_t k) {
+                if (problem.repair) problem.repair(samples[k]);
+                violations[k] = violationOf(samples[k], streams[k]);
+                if (violations[k] == 0.0 && !problem.objectiveBatch) {
+                    RunCounters* counters = tally();
+                    ScopedTimer timer(counters ? &counters->objectiveNs : nullptr);
+                    values[k] = problem.objectiveSeeded ? problem.objectiveSeeded(samples[k], deriveStream(streams[k], 0))
+                                                        : problem.objective(samples[k]);
+                }
+            };
+            if (problem.parallelSafe) pool.parallelFor(m, check);
+            else for (std::size_t k = 0; k < m; ++k) check(k);
+
+            if (problem.objectiveBatch) {
+                // 한꺼번에 평가. 평가가 비싸므로 HM에 들어갈 실행 가능 해만
+                std::vector<std::vector<double>> points;
+                std::vector<std::uint64_t> objStreams;
+                std::vector<std::size_t> picked;
+                std::fill(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(m),
+                          std::numeric_limits<double>::quiet_NaN());
+                for (std::size_t k = 0; k < m && feasible.size() + picked.size() < count; ++k) {
+                    if (violations[k] != 0.0) continue;
+                    points.push_back(samples[k]);
+                    objStreams.push_back(deriveStream(streams[k], 0));
+                    picked.push_back(k);
+                }
+                std::vector<double> results;
+                if (!points.empty()) {
+                    RunCounters* counters = tally();
+                    ScopedTimer timer(counters ? &counters->objectiveNs : nullptr);
+                    problem.objectiveBatch(points, objStreams, results);
+                }
+                for (std::size_t j = 0; j < picked.size(); ++j)
+                    values[picked[j]] = std::isnan(results[j]) ? invalidValue() : results[j];
+                statistics.evaluations += picked.size();
+            }
+
+            for (std::size_t k = 0; k < m; ++k) {
+                if (counterSet) countCheck(samples[k], streams[k], violations[k]);
+                if (violations[k] == 0.0) {
+                    if (!problem.objectiveBatch) ++statistics.evaluations;
+                    else if (std::isnan(values[k])) continue; // 평가하지 않은 나머지
+                    if (!statistics.firstFeasibleAt) statistics.firstFeasibleAt = firstCandidate + k;
+                    if (surrogate && !std::isnan(values[k]) && values[k] != invalidValue()) feedSurrogate(samples[k], values[k]);
+                    if (feasible.size() < count) feasible.push_back({samples[k], values[k], 0.0});
+                    continue;
+                }
+                ++statistics.infeasible;
+                if (nearest.size() < count || violations[k] < nearest.back().first) {
+                    Harmony h{samples[k], invalidValue(), violations[k]};
+                    auto pos = std::upper_bound(nearest.begin(), nearest.end(), violations[k],
+                                                [](double v, const auto& e) { return v < e.first; });
+                    nearest.insert(pos, {violations[k], std::move(h)});
+                    if (nearest.size() > count) nearest.pop_back();
+                }
+            }
+            tried += m;
+        }
 
-        while (true) {
-            std::vector<double> vars(problem.variables.size());
+        statistics.initSamples += tried;
+        if (feasible.size() < count) {
+            if (feasible.empty()) {
+                out << "[WARN] No feasible point found in " << tried << " initial samples"
+                          << " (smallest total constraint violation: " << nearest.front().first << ").\n"
+                          << "       Check the [ST] constraints or raise InitBudget; "
+                          << "the HM starts from the least-violating points." << std::endl;
+            } else {
+                out << "[WARN] Only " << feasible.size() << " of " << count << " initial harmonies are feasible after "
+                          << tried << " samples; the rest are the least-violating points." << std::endl;
+            }
+            for (std::size_t k = 0; feasible.size() < count && k < nearest.size(); ++k)
+                feasible.push_back(std::move(nearest[k].second));
+        }
+        return feasible;
+    }
 
-            for (size_t i = 0; i < problem.variables.size(); i++) {
+    // 주어진 해들(WarmStart 파일, presetMemory)로 초기 HM을 채운다. 범위 밖 값은 자르고 새 모델로 다시 평가해
+    // 실행 가능한 해만 (중복 제외, 좋은 순으로 최대 count개) 남긴다. 모자란 자리는 호출 쪽에서 새 표본으로 채움
+    std::vector<Harmony> HarmonySearch::admitHarmonies(std::vector<std::vector<double>> vectors, std::size_t count,
+                                                       const std::string& source) {
+        std::vector<Harmony> kept;
+        std::size_t infeasible = 0, duplicates = 0, clipped = 0;
+        for (auto& x : vectors) {
+            bool moved = false;
+            for (std::size_t i = 0; i < x.size(); ++i) {
                 const auto& var = problem.variables[i];
+                double v = std::clamp(x[i], var.range.first, var.range.second);
+                if (var.isInt) v = std::round(v);
+                moved |= v != x[i];
+                x[i] = v;
+            }
+            if (problem.repair) problem.repair(x);
+            if (moved) ++clipped;
+            if (std::any_of(kept.begin(), kept.end(), [&](const Harmony& h) { return h.vars == x; })) {
+                ++duplicates;
+                continue;
+            }
+
+            Harmony h{std::move(x), 0.0};
+            bool aborted = false;
+            evaluate(h, nextStream(), nullptr, aborted);
+            if (h.violation > 0.0) {
+                ++infeasible;
+                continue;
+            }
+            kept.push_back(std::move(h));
+        }
+        if (kept.size() > count) {
+            std::stable_sort(kept.begin(), kept.end(), [this](const Harmony& a, const Harmony& b) { return precedes(a, b); });
+            kept.resize(count);
+        }
+
+        out << "[INFO] Warm start from " << source << ": kept " << kept.size() << " of "
+                  << vectors.size() << " harmonies";
+        if (infeasible) out << ", " << infeasible << " infeasible";
+        if (duplicates) out << ", " << duplicates << " duplicates";
+        if (clipped) out << ", " << clipped << " clipped to the variable bounds";
+        out << std::endl;
+        return kept;
+    }
+
+    // HM 업데이트 (worst 교체). 교체했으면 true
+    bool HarmonySearch::insertHarmony(const Harmony& h) {
+        RunCounters* counters = tally();
+        ScopedTimer timer(counters ? &counters->insertNs : nullptr);
+        if (dedup && index.contains(h.vars)) return false; // 평가 중 보정으로 기존 멤버와 같아진 경우
+        Harmony& worst = HM[worstIndex()];
+        if (precedes(h, worst)) {
+            index.remove(worst.vars);
+            index.add(h.vars);
+            if (trace) traceReplace(worst, h);
+            worst = h;
+            spreadStale = true;
+            if (counters) ++counters->replacements;
+            return true;
+        }
+        return false;
+    }
+
+    // HM을 통째로 바꾼 뒤 색인을 다시 만든다
+    void HarmonySearch::reindex() {
+        index.clear();
+        for (const auto& h : HM) index.add(h.vars);
+        spreadStale = true;
+        if (trace) traceRebuild();
+    }
+
+    // Trace: HM의 변수별 (범위로 정규화한) 합/제곱합과 유한한 목적 값의 합을 처음부터 다시 계산
+    void HarmonySearch::traceRebuild() {
+        const std::size_t n = problem.variables.size();
+        moments.sum.assign(n, 0.0);
+        moments.sumSq.assign(n, 0.0);
+        moments.valueSum = 0.0;
+        moments.finite = 0;
+        moments.updates = 0;
+        for (const auto& h : HM) traceAdd(h, 1.0);
+    }
+
+    void HarmonySearch::traceAdd(const Harmony& h, double sign) {
+        for (std::size_t i = 0; i < h.vars.size(); ++i) {
+            const auto& var = problem.variables[i];
+            const double span = var.range.second - var.range.first;
+            const double u = span > 0.0 ? (h.vars[i] - var.range.first) / span : 0.0;
+            moments.sum[i] += sign * u;
+            moments.sumSq[i] += sign * u * u;
+        }
+        if (std::isfinite(h.value)) {
+            moments.valueSum += sign * h.value;
+            moments.finite += sign > 0.0 ? 1 : -1;
+        }
+    }
+
+    // 교체 한 번은 O(n). 누적 오차가 쌓이지 않도록 가끔 처음부터 다시 계산한다
+    void HarmonySearch::traceReplace(const Harmony& removed, const Harmony& added) {
+        if (++moments.updates >= 4096) traceRebuild(); // 아직 교체 전의 HM이므로 아래에서 마저 반영
+        traceAdd(removed, -1.0);
+        traceAdd(added, 1.0);
+    }
+
+    void HarmonySearch::tracePoint(unsigned int iter, const Harmony& incumbent,
+                                   std::chrono::steady_clock::time_point start) {
+        const double m = static_cast<double>(HM.size());
+        double diversity = 0.0;
+        for (std::size_t i = 0; i < moments.sum.size(); ++i) {
+            const double mean = moments.sum[i] / m;
+            diversity += std::sqrt(std::max(0.0, moments.sumSq[i] / m - mean * mean));
+        }
+        TracePoint p;
+        p.iteration = iter;
+        p.evaluations = statistics.evaluations;
+        p.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        p.best = incumbent.value;
+        p.worst = worstValue();
+        p.mean = moments.finite > 0 ? moments.valueSum / static_cast<double>(moments.finite)
+                                    : std::numeric_limits<double>::quiet_NaN();
+        p.diversity = moments.sum.empty() ? 0.0 : diversity / static_cast<double>(moments.sum.size());
+        trace->push(p);
+    }
+
+    // 변수 i의 음정 조정 대역폭. [VAR]의 bw가 있으면 그 값, Bandwidth = Spread면 HM에서의 표준편차, 아니면 범위/N_Seg.
+    // ratio는 IHS/SGHS의 범위 대비 비율(0: 고정 대역폭)이고, bw/Spread 값은 BWmax를 시작으로 같은 비율로 줄인다
+    double HarmonySearch::bandwidth(std::size_t i, double ratio) {
+        const auto& var = problem.variables[i];
+        const double span = var.range.second - var.range.first;
+        double base = var.bandwidth;
+        if (base <= 0.0 && params.Bandwidth == BandwidthMode::Spread) {
+            if (spreadStale) {
+                const std::size_t n = problem.variables.size();
+                const auto count = static_cast<double>(HM.size());
+                spread.assign(n, 0.0);
+                for (std::size_t j = 0; j < n; ++j) {
+                    double mean = 0.0, sq = 0.0;
+                    for (const auto& h : HM) mean += h.vars[j];
+                    mean /= count;
+                    for (const auto& h : HM) sq += (h.vars[j] - mean) * (h.vars[j] - mean);
+                    const auto& v = problem.variables[j];
+                    spread[j] = std::max(std::sqrt(sq / count), (v.range.second - v.range.first) * params.BWmin);
+                }
+                spreadStale = false;
+            }
+            base = spread[i];
+        }
+        if (base <= 0.0) return ratio > 0.0 ? span * ratio : span / params.N_Seg;
+        return ratio > 0.0 && params.BWmax > 0.0 ? base * (ratio / params.BWmax) : base;
+    }
+
+    // x를 ±bw 옮긴다. int 변수는 1..round(bw) 중 하나의 정수 칸만큼 옮겨서 반올림으로 제자리에 돌아오지 않게 하고,
+    // 이미 경계에 있어 한쪽으로 못 가면 반대쪽으로 옮긴다
+    double HarmonySearch::pitchAdjust(std::size_t i, double x, double bw) {
+        const auto& var = problem.variables[i];
+        bool up = rng() % 2 == 0;
+        if (up && x >= var.range.second) up = false;
+        else if (!up && x <= var.range.first) up = true;
+        if (var.isInt) {
+            const auto reach = static_cast<std::uint32_t>(std::clamp(std::round(bw), 1.0, 1e9));
+            const double k = 1.0 + static_cast<double>(rng() % reach);
+            return std::clamp(std::round(up ? x + k : x - k), var.range.first, var.range.second);
+        }
+        return up ? std::min(var.range.second, x + bw) : std::max(var.range.first, x - bw);
+    }
+
+    const Harmony& HarmonySearch::best() const {
+        return *std::min_element(HM.begin(), HM.end(),
+                                 [this](const Harmony& a, const Harmony& b) { return precedes(a, b); });
+    }
+
+    // 후보 하나 즉흥 연주. iter는 IHS/SGHS 일정 계산용.
+    void HarmonySearch::improvise(std::vector<double>& newVars, unsigned int iter) {
+        RunCounters* counters = tally();
+        ScopedTimer timer(counters ? &counters->improviseNs : nullptr);
+        std::uint64_t pitched = 0, drawn = 0; // Stats: 음정 조정/새로 뽑은 변수 수
+        const double progress = params.MaxImp ? static_cast<double>(iter) / params.MaxImp : 0.0;
+        const HSVariant variant = params.Variant;
+
+        double HMCR = params.HMCR;
+        double PAR = params.PAR;
+        double bwRatio = 0.0; // IHS/SGHS: 변수 범위 대비 대역폭
+        const Harmony* gbest = nullptr;
+
+        switch (variant) {
+            case HSVariant::HS:
+                break;
+            case HSVariant::IHS:
+                PAR = params.PARmin + (params.PARmax - params.PARmin) * progress;
+                bwRatio = params.BWmax * std::exp(std::log(params.BWmin / params.BWmax) * progress);
+                break;
+            case HSVariant::GHS:
+                PAR = params.PARmin + (params.PARmax - params.PARmin) * progress;
+                gbest = &best();
+                break;
+            case HSVariant::SGHS: {
+                std::normal_distribution<double> hmcrDist(adaptive.HMCRm, 0.01);
+                std::normal_distribution<double> parDist(adaptive.PARm, 0.05);
+                HMCR = std::clamp(hmcrDist(rng), 0.0, 1.0);
+                PAR = std::clamp(parDist(rng), 0.0, 1.0);
+                bwRatio = progress < 0.5 ? params.BWmax - (params.BWmax - params.BWmin) * 2.0 * progress
+                                         : params.BWmin;
+                gbest = &best();
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < problem.variables.size(); ++i) {
+            const auto& var = problem.variables[i];
+            auto r = std::generate_canonical<double, 10>(rng);
+            if (r < HMCR) {
+                const auto& randHarmony = HM[rng() % HM.size()];
+                newVars[i] = randHarmony.vars[i];
+
+                if (variant == HSVariant::SGHS) {
+                    // SGHS: 기억 고려 단계에서 항상 ±U(0,1)*bw 이동, 음정 조정은 최적 해 성분 복사
+                    double bw = bandwidth(i, bwRatio);
+                    double u = std::generate_canonical<double, 10>(rng);
+                    newVars[i] += (rng() % 2 == 0) ? u * bw : -u * bw;
+                    newVars[i] = std::clamp(newVars[i], var.range.first, var.range.second);
+                    if (std::generate_canonical<double, 10>(rng) < PAR) {
+                        newVars[i] = gbest->vars[i];
+                        ++pitched;
+                    }
+                    if (var.isInt) newVars[i] = std::round(newVars[i]);
+                } else if (std::generate_canonical<double, 10>(rng) < PAR) {
+                    ++pitched;
+                    if (variant == HSVariant::GHS) {
+                        // GHS: 최적 해의 임의 성분 k를 가져와 이 변수의 범위로 제한
+                        size_t k = rng() % problem.variables.size();
+                        newVars[i] = std::clamp(gbest->vars[k], var.range.first, var.range.second);
+                        if (var.isInt) newVars[i] = std::round(newVars[i]);
+                    } else {
+                        newVars[i] = pitchAdjust(i, newVars[i], bandwidth(i, bwRatio));
+                    }
+                }
+            } else {
+                ++drawn;
                 if (var.isInt) {
                     std::uniform_int_distribution<int> idist(
                         static_cast<int>(var.range.first),
                         static_cast<int>(var.range.second)
                     );
-                    vars[i] = idist(rng);
+                    newVars[i] = idist(rng);
                 } else {
                     std::uniform_real_distribution<double> rdist(
                         var.range.first, var.range.second
                     );
-                    vars[i] = rdist(rng);
+                    newVars[i] = rdist(rng);
+                }
+            }
+        }
+
+        if (counters) {
+            ++counters->improvisations;
+            counters->fromPitch += pitched;
+            counters->fromRandom += drawn;
+            counters->fromMemory += problem.variables.size() - pitched - drawn;
+        }
+
+        // SGHS: HM 교체에 성공하면 optimize에서 good 목록에 넣는다
+        lastHMCR = HMCR;
+        lastPAR = PAR;
+    }
+
+    // objectiveBatch가 있을 때: 지금 HM에서 후보 count개를 즉흥 연주하고(반복 번호 iter, iter+1, ...) 목적 값은 한 번에 평가해
+    // queue 뒤에 붙인다. 같은 묶음의 후보끼리는 서로의 HM 반영 결과를 보지 못하므로, 결과는 batchSize에 따라 달라지고
+    // 체크포인트에서 이어서 실행해도 batchSize가 1일 때만 중단 없이 돌린 것과 같다
+    void HarmonySearch::improviseBatch(unsigned int iter, std::size_t count, std::deque<Pending>& queue) {
+        const std::size_t n = problem.variables.size();
+        const bool repairing = !params.Repair.empty() && problem.constraintViolations;
+        std::vector<std::vector<double>> points;
+        std::vector<std::uint64_t> streams;
+        std::vector<std::size_t> slots; // points[j]의 queue 위치
+
+        for (std::size_t k = 0; k < count; ++k) {
+            Pending p{Harmony{std::vector<double>(n), 0.0}, false, 0.0, 0.0};
+            improvise(p.h.vars, iter + static_cast<unsigned int>(k));
+            p.HMCR = lastHMCR;
+            p.PAR = lastPAR;
+            if (problem.repair) problem.repair(p.h.vars);
+
+            // Dedup: HM 멤버 또는 같은 묶음의 앞선 후보와 같으면 평가하지 않음
+            p.duplicate = dedup && (index.contains(p.h.vars) ||
+                                    std::find(points.begin(), points.end(), p.h.vars) != points.end());
+            if (p.duplicate) {
+                ++statistics.duplicatesSkipped;
+                queue.push_back(std::move(p));
+                continue;
+            }
+
+            auto stream = nextStream();
+            if (repairing) repairCandidate(p.h, stream);
+            else p.h.violation = violationOf(p.h.vars, stream);
+            if (cache) {
+                ++statistics.cacheLookups;
+                if (cache->lookup(p.h.vars, p.h.value, p.h.violation)) {
+                    ++statistics.cacheHits;
+                    queue.push_back(std::move(p));
+                    continue;
                 }
             }
+            if (p.h.violation > 0.0) ++statistics.infeasible;
+            else if (!statistics.firstFeasibleAt) statistics.firstFeasibleAt = evalCount;
+            if (counterSet) countCheck(p.h.vars, stream, p.h.violation);
+            p.cutoff = objectiveCutoff(p.h.violation, HM[worstIndex()]);
+            if (needsObjective(p.h.violation) && screenOut(p.h, stream, p.cutoff, p.predicted, p.prediction)) {
+                p.h.value = invalidValue();
+            } else if (needsObjective(p.h.violation)) {
+                points.push_back(p.h.vars);
+                streams.push_back(deriveStream(stream, 0));
+                slots.push_back(queue.size());
+            } else {
+                p.h.value = invalidValue();
+            }
+            queue.push_back(std::move(p));
+        }
+        if (points.empty()) return;
 
-            // 제약 조건 확인
-            if (problem.penalty(vars) == 0.0) {
-                double val = evaluate(vars);
-                return {vars, val};
+        std::vector<double> values;
+        {
+            RunCounters* counters = tally();
+            ScopedTimer timer(counters ? &counters->objectiveNs : nullptr);
+            problem.objectiveBatch(points, streams, values);
+        }
+        statistics.evaluations += points.size();
+        for (std::size_t j = 0; j < points.size(); ++j) {
+            Harmony& h = queue[slots[j]].h;
+            if (std::isnan(values[j])) {
+                h.value = invalidValue(); // 실패한 평가는 캐시에 남기지 않음 (다시 시도할 수 있게)
+                continue;
             }
-            // 위반이면 다시 루프 (VBA판과 동일)
+            h.value = values[j];
+            if (cache) cache->insert(h.vars, h.value, h.violation);
+            learn(h, queue[slots[j]].predicted, queue[slots[j]].prediction, queue[slots[j]].cutoff);
         }
     }
 
-    // HM 업데이트 (worst 교체)
-    void HarmonySearch::insertHarmony(const Harmony& h) {
-        if (problem.maximize) {
-            auto worstIt = std::min_element(
-                HM.begin(), HM.end(),
-                [](const Harmony& a, const Harmony& b) { return a.value < b.value; }
-            );
-            if (h.value > worstIt->value) *worstIt = h;
-        } else {
-            auto worstIt = std::max_element(
-                HM.begin(), HM.end(),
-                [](const Harmony& a, const Harmony& b) { return a.value < b.value; }
-            );
-            if (h.value < worstIt->value) *worstIt = h;
+    // MaxImp 이외의 종료 조건 검사. 걸리면 statistics에 이유를 기록하고 true
+    bool HarmonySearch::shouldStop(unsigned int iter, const Harmony& incumbent, unsigned int lastImprovement,
+                                   std::chrono::steady_clock::time_point start) {
+        auto stop = [&](StopReason r) {
+            statistics.stopReason = r;
+            return true;
+        };
+
+        const double bestValue = incumbent.value;
+        if (!std::isnan(params.Target) && incumbent.violation == 0.0 &&
+            (problem.maximize ? bestValue >= params.Target : bestValue <= params.Target))
+            return stop(StopReason::Target);
+
+        if (params.StallWindow > 0 && iter - lastImprovement >= params.StallWindow)
+            return stop(StopReason::Stall);
+
+        // HM 전체 순회와 시계 읽기는 16회에 한 번만
+        if ((iter & 15u) != 0) return false;
+
+        if (params.SpreadEps > 0.0) {
+            double spread = std::fabs(worstValue() - bestValue) / std::max(std::fabs(bestValue), 1.0);
+            if (spread < params.SpreadEps) return stop(StopReason::Spread);
+        }
+
+        if (params.TimeLimit > 0.0) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (elapsed >= params.TimeLimit) return stop(StopReason::TimeLimit);
         }
+        return false;
+    }
+
+    // 최적 해 하나만 남기고 HM을 (더 크게) 다시 채운다. 새로 만든 해의 수(= 소모한 예산)를 반환
+    unsigned int HarmonySearch::restartMemory(unsigned int remaining) {
+        Harmony elite = best();
+        auto grown = static_cast<std::size_t>(std::lround(static_cast<double>(HM.size()) * params.RestartHMSFactor));
+        // 재초기화에 남은 예산의 절반 이상은 쓰지 않는다
+        std::size_t newHMS = std::clamp<std::size_t>(grown, 2, std::max<std::size_t>(2, remaining / 2));
+
+        HM.clear();
+        HM.reserve(newHMS);
+        HM.push_back(std::move(elite));
+        for (auto& h : initialHarmonies(newHMS - 1)) HM.push_back(std::move(h));
+        completeObjectives();
+        reindex();
+
+        ++statistics.restarts;
+        out << "\n[INFO] Restart " << statistics.restarts << ": HMS = " << newHMS << std::endl;
+        return static_cast<unsigned int>(newHMS - 1);
+    }
+
+    void HarmonySearch::saveState(Checkpoint& cp, unsigned int iter, unsigned int lastImprovement,
+                                  unsigned int lastRestart, const Harmony& incumbent, double elapsed) const {
+        cp.problemHash = problemHash(problem);
+        cp.seed = seed;
+        cp.evalCount = evalCount;
+        cp.iteration = iter;
+        cp.lastImprovement = lastImprovement;
+        cp.lastRestart = lastRestart;
+        cp.elapsed = elapsed;
+        std::ostringstream rngState;
+        rngState << rng;
+        cp.rngState = rngState.str();
+        cp.HM = HM;
+        cp.incumbent = incumbent;
+        cp.stats = statistics;
+        cp.adaptive = adaptive;
+        cp.penaltyWeight = penaltyWeight;
+        cp.penaltyRun = penaltyRun;
+        cp.penaltyRunFeasible = penaltyRunFeasible;
+        cp.epsilon0 = epsilon0;
+        cp.epsilon = epsilon;
+    }
+
+    void HarmonySearch::restoreState(const Checkpoint& cp) {
+        if (cp.problemHash != problemHash(problem))
+            throw std::runtime_error("Checkpoint " + params.Checkpoint + " was written for a different model");
+        for (const auto& h : cp.HM)
+            if (h.vars.size() != problem.variables.size())
+                throw std::runtime_error("Checkpoint " + params.Checkpoint + " does not match the model's variables");
+        seed = cp.seed;
+        evalCount = cp.evalCount;
+        std::istringstream rngState(cp.rngState);
+        rngState >> rng;
+        if (!rngState) throw std::runtime_error("Checkpoint " + params.Checkpoint + " has an invalid RNG state");
+        HM = cp.HM;
+        statistics = cp.stats;
+        adaptive = cp.adaptive;
+        penaltyWeight = cp.penaltyWeight;
+        penaltyRun = cp.penaltyRun;
+        penaltyRunFeasible = cp.penaltyRunFeasible;
+        epsilon0 = cp.epsilon0;
+        epsilon = cp.epsilon;
+        statistics.stopReason = StopReason::MaxImp;
     }
 
     // 최적화 수행
     Harmony HarmonySearch::optimize() {
-        HM.clear();
-        HM.reserve(params.HMS);
+        progress = Progress{};
+        return run(params.MaxImp);
+    }
+
+    Harmony HarmonySearch::advance(unsigned int until) {
+        return run(std::min(until, params.MaxImp));
+    }
+
+    // HM 멤버와 같지 않고 worst보다 나으면 평가 없이 넣는다
+    void HarmonySearch::inject(const Harmony& h) {
+        if (HM.empty() || index.contains(h.vars)) return;
+        if (insertHarmony(h) && precedes(h, progress.incumbent)) progress.incumbent = h;
+    }
+
+    // 반복 until 직전까지 진행한다. progress.started면 advance로 멈춘 곳에서 HM과 상태를 그대로 이어간다
+    Harmony HarmonySearch::run(unsigned int until) {
+        const bool continuing = progress.started;
+        auto start = continuing ? progress.start : std::chrono::steady_clock::now();
+        statistics.stopReason = StopReason::MaxImp;
+        if (!continuing) {
+            HM.clear();
+            HM.reserve(params.HMS);
+            adaptive = AdaptiveState{};
+            penaltyWeight = params.PenaltyWeight;
+            penaltyRun = 0;
+        }
+
+        Checkpoint snapshot;
+        bool resumed = false;
+        if (!continuing && params.Resume && !params.Checkpoint.empty()) {
+            // 대리 모델의 보관소와 맞춤 세대는 체크포인트에 담지 않으므로 같은 경로로 이어갈 수 없다
+            if (surrogate) throw std::runtime_error("Resume cannot be combined with Surrogate");
+            resumed = readCheckpoint(params.Checkpoint, snapshot);
+            if (resumed) {
+                restoreState(snapshot);
+                start -= std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(snapshot.elapsed));
+                out << "[INFO] Resuming from " << params.Checkpoint << " at iteration "
+                          << snapshot.iteration << " (seed " << seed << ")" << std::endl;
+            } else {
+                out << "[WARN] No checkpoint at " << params.Checkpoint << "; starting a new run." << std::endl;
+            }
+        }
+        std::unique_ptr<CheckpointWriter> writer;
+        if (!params.Checkpoint.empty()) writer = std::make_unique<CheckpointWriter>(params.Checkpoint);
+        if (!params.Trace.empty()) trace = std::make_unique<TraceWriter>(params.Trace);
 
         // 1. 초기 HM 생성
-        for (int i = 0; i < params.HMS; ++i)
-            HM.push_back(generateFeasibleSolution());
+        if (!resumed && !continuing) {
+            const auto hms = static_cast<std::size_t>(std::max(params.HMS, 1));
+            auto seeds = std::move(presets);
+            presets.clear();
+            if (!params.WarmStart.empty()) {
+                auto loaded = loadWarmStart(params.WarmStart, problem.variables);
+                seeds.insert(seeds.end(), std::make_move_iterator(loaded.begin()), std::make_move_iterator(loaded.end()));
+            }
+            if (!seeds.empty())
+                HM = admitHarmonies(std::move(seeds), hms, params.WarmStart.empty() ? "preset memory" : params.WarmStart);
+            for (auto& h : initialHarmonies(hms - HM.size())) HM.push_back(std::move(h));
+            if (params.Constraints == ConstraintMode::Epsilon) {
+                // ε(0): 초기 HM에서 위반 정도가 상위 20% 경계인 해의 값
+                std::vector<double> v;
+                for (const auto& h : HM) v.push_back(h.violation);
+                auto theta = v.begin() + static_cast<std::ptrdiff_t>(v.size() / 5);
+                std::nth_element(v.begin(), theta, v.end());
+                epsilon0 = epsilon = *theta;
+            }
+            completeObjectives();
+        }
+        reindex();
 
         // 2. 진행률 표시줄 설정
         const int barWidth = 50;
-        hsl::cout << "[INFO] Optimization started..." << std::endl;
+        if (!continuing) out << "[INFO] Optimization started..." << std::endl;
+        if (!continuing && problem.model && !problem.model->equalityRepairs.empty()) {
+            out << "[INFO] Equality constraints solved in closed form for:";
+            for (const auto& r : problem.model->equalityRepairs)
+                out << " " << problem.variables[r.pivot].name;
+            out << std::endl;
+        }
 
         auto print_progress = [&](int iter) {
             float progress = static_cast<float>(iter) / params.MaxImp;
             int pos = static_cast<int>(barWidth * progress);
 
-            hsl::cout << "\r[";
+            out << "\r[";
             for (int i = 0; i < barWidth; ++i)
-                hsl::cout << (i < pos ? "#" : "-");
-            hsl::cout << "] "
+                out << (i < pos ? "#" : "-");
+            out << "] "
                       << std::setw(3) << int(progress * 100.0f) << "% "
+                      << "(HM distinct " << index.distinct() << "/" << HM.size() << ")   "
                       << std::flush;
         };
 
+        Harmony incumbent = continuing ? progress.incumbent : resumed ? snapshot.incumbent : best();
+
         // 3. 반복 개선
-        for (int iter = 0; iter < params.MaxImp; ++iter) {
-            std::vector<double> newVars(problem.variables.size());
+        Harmony candidate{std::vector<double>(problem.variables.size()), 0.0};
+        std::deque<Pending> pending;
+        const std::size_t batchSize = std::max<std::size_t>(1, problem.batchSize);
+        unsigned int lastImprovement = continuing ? progress.lastImprovement : resumed ? snapshot.lastImprovement : 0;
+        unsigned int lastRestart = continuing ? progress.lastRestart : resumed ? snapshot.lastRestart : 0;
+        const unsigned int restartStall = params.RestartStall ? params.RestartStall
+                                                              : std::max(1u, params.MaxImp / 20);
+        auto takeSnapshot = [&](unsigned int next) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            saveState(snapshot, next, lastImprovement, lastRestart, incumbent, elapsed);
+            writer->submit(snapshot);
+            if (auto error = writer->takeError(); !error.empty())
+                out << "\n[WARN] Checkpoint not written: " << error << std::endl;
+        };
+        unsigned int iter = continuing ? progress.iteration : resumed ? snapshot.iteration : 0;
 
-            for (size_t i = 0; i < problem.variables.size(); ++i) {
-                auto r = std::generate_canonical<double, 10>(rng);
-                if (r < params.HMCR) {
-                    const auto& randHarmony = HM[rng() % HM.size()];
-                    newVars[i] = randHarmony.vars[i];
+        // Trace: TraceInterval초 또는 TraceEvery 반복마다 한 점 (시간 간격이면 시계는 16회에 한 번만 읽음)
+        const auto traceStep = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(params.TraceInterval));
+        auto nextTrace = std::chrono::steady_clock::now() + traceStep;
+        unsigned int lastTraced = iter;
+        auto traceDue = [&](unsigned int done) {
+            if (params.TraceInterval > 0.0) {
+                if ((done & 15u) != 0) return false;
+                auto now = std::chrono::steady_clock::now();
+                if (now < nextTrace) return false;
+                nextTrace = now + traceStep;
+                return true;
+            }
+            return params.TraceEvery > 0 && done % params.TraceEvery == 0;
+        };
+        if (trace) tracePoint(iter, incumbent, start);
 
-                    if (std::generate_canonical<double, 10>(rng) < params.PAR) {
-                        const auto& var = problem.variables[i];
-                        double bw = (var.range.second - var.range.first) / params.N_Seg;
-                        if (rng() % 2 == 0)
-                            newVars[i] = std::min(var.range.second, newVars[i] + bw);
-                        else
-                            newVars[i] = std::max(var.range.first, newVars[i] - bw);
-                        if (var.isInt) newVars[i] = std::round(newVars[i]);
-                    }
-                } else {
-                    const auto& var = problem.variables[i];
-                    if (var.isInt) {
-                        std::uniform_int_distribution<int> idist(
-                            static_cast<int>(var.range.first),
-                            static_cast<int>(var.range.second)
-                        );
-                        newVars[i] = idist(rng);
-                    } else {
-                        std::uniform_real_distribution<double> rdist(
-                            var.range.first, var.range.second
-                        );
-                        newVars[i] = rdist(rng);
+        for (; iter < until; ++iter) {
+            updateConstraintHandling(iter);
+            if (shouldStop(iter, incumbent, lastImprovement, start)) break;
+
+            bool duplicate = false;
+            if (problem.objectiveBatch) {
+                // 묶음 평가: 대기열이 비면 batchSize개를 한꺼번에 즉흥 연주/평가하고, 반영은 반복마다 하나씩
+                if (pending.empty())
+                    improviseBatch(iter, std::min<std::size_t>(batchSize, until - iter), pending);
+                Pending& next = pending.front();
+                candidate = std::move(next.h);
+                duplicate = next.duplicate;
+                lastHMCR = next.HMCR;
+                lastPAR = next.PAR;
+                pending.pop_front();
+            } else {
+                improvise(candidate.vars, iter);
+                if (problem.repair) problem.repair(candidate.vars);
+
+                // Dedup: HM 멤버와 같은(DedupTol이면 근접한) 해는 HM에 넣지 않으므로 평가도 건너뜀
+                duplicate = dedup && index.contains(candidate.vars);
+                if (duplicate) ++statistics.duplicatesSkipped;
+                else evaluateCandidate(candidate);
+            }
+            bool admissible = !duplicate &&
+                              (params.Constraints != ConstraintMode::Reject || candidate.violation == 0.0);
+            bool replaced = admissible && insertHarmony(candidate);
+
+            if (replaced && precedes(candidate, incumbent)) {
+                incumbent = candidate;
+                lastImprovement = iter + 1;
+                statistics.bestFoundAt = statistics.evaluations;
+            }
+
+            if (params.Variant == HSVariant::SGHS) {
+                if (replaced) {
+                    adaptive.goodHMCR.push_back(lastHMCR);
+                    adaptive.goodPAR.push_back(lastPAR);
+                }
+                if (params.LP > 0 && (iter + 1) % static_cast<unsigned int>(params.LP) == 0 && !adaptive.goodHMCR.empty()) {
+                    auto mean = [](const std::vector<double>& v) {
+                        double s = 0.0;
+                        for (double x : v) s += x;
+                        return s / static_cast<double>(v.size());
+                    };
+                    adaptive.HMCRm = mean(adaptive.goodHMCR);
+                    adaptive.PARm = mean(adaptive.goodPAR);
+                    adaptive.goodHMCR.clear();
+                    adaptive.goodPAR.clear();
+                }
+            }
+
+            // 정체: 최근 restartStall 반복 동안 개선이 없거나 HM이 한 점으로 수렴
+            if (statistics.restarts < params.Restarts) {
+                unsigned int since = iter + 1 - std::max(lastImprovement, lastRestart);
+                bool collapsed = (iter & 15u) == 0 &&
+                                 std::fabs(worstValue() - incumbent.value) <= 1e-12 * std::max(std::fabs(incumbent.value), 1.0);
+                if (since >= restartStall || collapsed) {
+                    unsigned int remaining = params.MaxImp - (iter + 1);
+                    if (remaining > 4) {
+                        iter += restartMemory(remaining);
+                        lastRestart = iter + 1;
+                        pending.clear(); // 이전 HM에서 즉흥 연주한 후보
                     }
                 }
             }
 
-            if (problem.penalty(newVars) == 0.0) {
-                double newVal = evaluate(newVars);
-                insertHarmony({newVars, newVal});
+            if (iter % 100 == 0 || iter >= params.MaxImp - 1)
+                print_progress(static_cast<int>(std::min(iter + 1, params.MaxImp)));
+
+            if (writer && params.CheckpointEvery > 0 && (iter + 1) % params.CheckpointEvery == 0)
+                takeSnapshot(iter + 1);
+
+            if (trace && traceDue(iter + 1)) {
+                tracePoint(iter + 1, incumbent, start);
+                lastTraced = iter + 1;
             }
+        }
+        progress = Progress{true, iter, lastImprovement, lastRestart, incumbent, start};
+
+        out << std::endl;
 
-            if (iter % 100 == 0 || iter == params.MaxImp - 1)
-                print_progress(iter + 1);
+        if (trace) {
+            if (lastTraced != iter) tracePoint(iter, incumbent, start);
+            trace->close();
+            if (auto error = trace->takeError(); !error.empty())
+                out << "[WARN] Trace not written: " << error << std::endl;
+            else
+                out << "[INFO] Trace: " << trace->written() << " points written to " << params.Trace << std::endl;
+            if (trace->stalls() > 0)
+                out << "[WARN] Trace: the search waited " << trace->stalls()
+                    << " times for the writer; raise TraceEvery or TraceInterval" << std::endl;
+            trace.reset();
         }
 
-        hsl::cout << std::endl;
+        if (writer) {
+            takeSnapshot(iter);
+            writer->close(); // 마지막 스냅숏 기록까지 대기
+            if (auto error = writer->takeError(); !error.empty())
+                out << "[WARN] Checkpoint not written: " << error << std::endl;
+            else
+                out << "[INFO] Checkpoint saved to " << params.Checkpoint << std::endl;
+        }
+
+        statistics.stopIteration = iter;
+        if (statistics.stopReason != StopReason::MaxImp) {
+            out << "[INFO] Stopped early (" << stopReasonName(statistics.stopReason)
+                      << ") at iteration " << iter << std::endl;
+        }
 
-        // 4. 최적 해 반환
-        return *std::max_element(HM.begin(), HM.end());
+        if (cache) {
+            std::ostringstream rate;
+            rate << std::fixed << std::setprecision(1) << statistics.cacheHitRate() * 100.0;
+            out << "[INFO] Evaluation cache: " << statistics.cacheHits << "/" << statistics.cacheLookups
+                      << " hits (" << rate.str() << "%)" << std::endl;
+        }
+        if (statistics.earlyAborts > 0) {
+            out << "[INFO] Early-aborted evaluations: " << statistics.earlyAborts
+                      << "/" << statistics.evaluations << std::endl;
+        }
+        if (statistics.duplicatesSkipped > 0) {
+            out << "[INFO] Skipped " << statistics.duplicatesSkipped
+                      << " improvisations already in the HM" << std::endl;
+        }
+        if (surrogate) {
+            out << "[INFO] Surrogate: skipped " << statistics.surrogateSkipped << " objective evaluations";
+            if (statistics.surrogateChecked > 0) {
+                std::ostringstream rate;
+                rate << std::fixed << std::setprecision(1)
+                     << 100.0 * static_cast<double>(statistics.surrogateAgreed) / static_cast<double>(statistics.surrogateChecked);
+                out << ", ranking against the HM worst right for " << statistics.surrogateAgreed << "/"
+                    << statistics.surrogateChecked << " evaluated predictions (" << rate.str() << "%)";
+            }
+            out << std::endl;
+        }
+        out << "[INFO] " << variantName(params.Variant) << ": best found after "
+                  << statistics.bestFoundAt << " evaluations" << std::endl;
+        if (statistics.repairAttempts > 0) {
+            std::ostringstream rate;
+            rate << std::fixed << std::setprecision(1)
+                 << 100.0 * static_cast<double>(statistics.repairSuccesses) / static_cast<double>(statistics.repairAttempts);
+            out << "[INFO] Repair: " << statistics.repairSuccesses << "/" << statistics.repairAttempts
+                      << " infeasible improvisations made feasible (" << rate.str() << "%)" << std::endl;
+        }
+        if (statistics.infeasible > 0) {
+            out << "[INFO] " << constraintModeName(params.Constraints) << " constraint handling: "
+                      << statistics.infeasible << " infeasible candidates, ";
+            if (statistics.firstFeasibleAt) out << "first feasible at candidate " << statistics.firstFeasibleAt;
+            else out << "no feasible candidate";
+            out << std::endl;
+        }
+
+        // 4. 최적 해 반환 (실행 가능 해 우선)
+        const Harmony& result = *std::min_element(HM.begin(), HM.end(), [this](const Harmony& a, const Harmony& b) {
+            if ((a.violation == 0.0) != (b.violation == 0.0)) return a.violation == 0.0;
+            return precedes(a, b);
+        });
+        if (result.violation > 0.0)
+            out << "[WARN] No feasible harmony found; the best one violates the constraints by "
+                      << result.violation << std::endl;
+        return result;
+    }
+
+    bool parseVariant(const std::string& name, HSVariant& out) {
+        if (name == "HS") out = HSVariant::HS;
+        else if (name == "IHS") out = HSVariant::IHS;
+        else if (name == "GHS") out = HSVariant::GHS;
+        else if (name == "SGHS") out = HSVariant::SGHS;
+        else return false;
+        return true;
+    }
+
+    bool parseEngine(const std::string& name, SolverEngine& out) {
+        if (name == "HS") out = SolverEngine::HS;
+        else if (name == "DE") out = SolverEngine::DE;
+        else if (name == "PSO") out = SolverEngine::PSO;
+        else if (name == "CMAES" || name == "CMA-ES") out = SolverEngine::CMAES;
+        else if (name == "Pattern") out = SolverEngine::Pattern;
+        else if (name == "Portfolio") out = SolverEngine::Portfolio;
+        else return false;
+        return true;
+    }
+
+    bool parseConstraintMode(const std::string& name, ConstraintMode& out) {
+        if (name == "Reject") out = ConstraintMode::Reject;
+        else if (name == "Static") out = ConstraintMode::Static;
+        else if (name == "Adaptive") out = ConstraintMode::Adaptive;
+        else if (name == "Epsilon") out = ConstraintMode::Epsilon;
+        else if (name == "Deb") out = ConstraintMode::Deb;
+        else return false;
+        return true;
+    }
+
+    bool parseRepairStages(const std::string& list, std::vector<RepairStage>& out) {
+        std::string words = list;
+        std::replace_if(words.begin(), words.end(), [](char ch) { return ch == '+' || ch == ','; }, ' ');
+        std::istringstream in(words);
+        std::vector<RepairStage> stages;
+        std::string name;
+        while (in >> name) {
+            if (name == "None") continue;
+            if (name == "Clamp") stages.push_back(RepairStage::Clamp);
+            else if (name == "Resample") stages.push_back(RepairStage::Resample);
+            else if (name == "Greedy") stages.push_back(RepairStage::Greedy);
+            else return false;
+        }
+        out = std::move(stages);
+        return true;
+    }
+
+    bool parseBandwidthMode(const std::string& name, BandwidthMode& out) {
+        if (name == "Range") out = BandwidthMode::Range;
+        else if (name == "Spread") out = BandwidthMode::Spread;
+        else return false;
+        return true;
+    }
+
+    const char* constraintModeName(ConstraintMode m) {
+        switch (m) {
+            case ConstraintMode::Reject: return "Reject";
+            case ConstraintMode::Static: return "Static";
+            case ConstraintMode::Adaptive: return "Adaptive";
+            case ConstraintMode::Epsilon: return "Epsilon";
+            case ConstraintMode::Deb: return "Deb";
+        }
+        return "Deb";
+    }
+
+    const char* stopReasonName(StopReason r) {
+        switch (r) {
+            case StopReason::MaxImp: return "MaxImp";
+            case StopReason::Target: return "target reached";
+            case StopReason::Stall: return "stall window";
+            case StopReason::Spread: return "HM spread";
+            case StopReason::TimeLimit: return "time limit";
+        }
+        return "MaxImp";
+    }
+
+    const char* variantName(HSVariant v) {
+        switch (v) {
+            case HSVariant::HS: return "HS";
+            case HSVariant::IHS: return "IHS";
+            case HSVariant::GHS: return "GHS";
+            case HSVariant::SGHS: return "SGHS";
+        }
+        return "HS";
+    }
+
+    const char* engineName(SolverEngine e) {
+        switch (e) {
+            case SolverEngine::HS: return "HS";
+            case SolverEngine::DE: return "DE";
+            case SolverEngine::PSO: return "PSO";
+            case SolverEngine::CMAES: return "CMA-ES";
+            case SolverEngine::Pattern: return "Pattern";
+            case SolverEngine::Portfolio: return "Portfolio";
+        }
+        return "HS";
     }
 
     // 파라미터 로드/수정
     HSParams loadParams(const std::string& filename) {
         HSParams p{};
         std::ifstream in(filename);
-        std::string key;
-        while (in >> key) {
-            if (key == "HMS") in.ignore(1, ',') >> p.HMS;
-            else if (key == "HMCR") in.ignore(1, ',') >> p.HMCR;
-            else if (key == "PAR") in.ignore(1, ',') >> p.PAR;
-            else if (key == "MaxImp") in.ignore(1, ',') >> p.MaxImp;
-            else if (key == "N_Seg") in.ignore(1, ',') >> p.N_Seg;
+        std::string line;
+        // "KEY,value" 한 줄씩 (GUI의 ParamStruct::FromCSV와 같은 형식)
+        while (std::getline(in, line)) {
+            auto comma = line.find(',');
+            if (comma == std::string::npos) continue;
+            std::string key = line.substr(0, comma);
+            std::istringstream val(line.substr(comma + 1));
+            if (key == "HMS") val >> p.HMS;
+            else if (key == "HMCR") val >> p.HMCR;
+            else if (key == "PAR") val >> p.PAR;
+            else if (key == "MaxImp") val >> p.MaxImp;
+            else if (key == "N_Seg") val >> p.N_Seg;
+            else if (key == "CacheSize") val >> p.CacheSize;
+            else if (key == "EarlyAbort") val >> p.EarlyAbort;
+            else if (key == "Variant") {
+                std::string name;
+                val >> name;
+                if (!parseVariant(name, p.Variant))
+                    throw std::runtime_error("Unknown HS variant in parameter file: " + name);
+            }
+            else if (key == "Engine") {
+                std::string name;
+                val >> name;
+                if (!parseEngine(name, p.Engine))
+                    throw std::runtime_error("Unknown engine in parameter file: " + name);
+            }
+            else if (key == "PopSize") val >> p.PopSize;
+            else if (key == "PARmin") val >> p.PARmin;
+            else if (key == "PARmax") val >> p.PARmax;
+            else if (key == "BWmin") val >> p.BWmin;
+            else if (key == "BWmax") val >> p.BWmax;
+            else if (key == "LP") val >> p.LP;
+            else if (key == "Target") val >> p.Target;
+            else if (key == "StallWindow") val >> p.StallWindow;
+            else if (key == "SpreadEps") val >> p.SpreadEps;
+            else if (key == "TimeLimit") val >> p.TimeLimit;
+            else if (key == "Restarts") val >> p.Restarts;
+            else if (key == "RestartStall") val >> p.RestartStall;
+            else if (key == "RestartHMSFactor") val >> p.RestartHMSFactor;
+            else if (key == "InitBudget") val >> p.InitBudget;
+            else if (key == "Bandwidth") {
+                std::string name;
+                val >> name;
+                if (!parseBandwidthMode(name, p.Bandwidth))
+                    throw std::runtime_error("Unknown bandwidth mode in parameter file: " + name);
+            }
+            else if (key == "Dedup") val >> p.Dedup;
+            else if (key == "DedupTol") val >> p.DedupTol;
+            else if (key == "Constraints") {
+                std::string name;
+                val >> name;
+                if (!parseConstraintMode(name, p.Constraints))
+                    throw std::runtime_error("Unknown constraint handling mode in parameter file: " + name);
+            }
+            else if (key == "PenaltyWeight") val >> p.PenaltyWeight;
+            else if (key == "EqTolerance") val >> p.EqTolerance;
+            else if (key == "Repair") {
+                if (!parseRepairStages(val.str(), p.Repair))
+                    throw std::runtime_error("Unknown repair stage in parameter file: " + val.str());
+            }
+            else if (key == "RepairTries") val >> p.RepairTries;
+            else if (key == "WarmStart") std::getline(val >> std::ws, p.WarmStart);
+            else if (key == "Checkpoint") std::getline(val >> std::ws, p.Checkpoint);
+            else if (key == "CheckpointEvery") val >> p.CheckpointEvery;
+            else if (key == "Trace") std::getline(val >> std::ws, p.Trace);
+            else if (key == "TraceEvery") val >> p.TraceEvery;
+            else if (key == "TraceInterval") val >> p.TraceInterval;
+            else if (key == "Resume") val >> p.Resume;
+            else if (key == "Quiet") val >> p.Quiet;
+            else if (key == "Stats") val >> p.Stats;
+            else if (key == "ProfileModel") val >> p.ProfileModel;
+            else if (key == "Decompose") val >> p.Decompose;
+            else if (key == "GroupSize") val >> p.GroupSize;
+            else if (key == "CCRounds") val >> p.CCRounds;
+            else if (key == "Surrogate") val >> p.Surrogate;
+            else if (key == "SurrogateSize") val >> p.SurrogateSize;
+            else if (key == "SurrogateExplore") val >> p.SurrogateExplore;
+            else if (key == "Workers") val >> p.Workers;
+            else if (key == "InFlight") val >> p.InFlight;
+            else if (key == "EvalTimeout") val >> p.EvalTimeout;
         }
         return p;
     }
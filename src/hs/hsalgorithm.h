@@ -2,9 +2,19 @@
 #define HSL_HSALGORITHM_
 
 #include <vector>
+#include <deque>
 #include <random>
+#include <cstdint>
 #include <ostream>
+#include <memory>
+#include <chrono>
+#include <string>
 #include "params.h"
+#include "evalcache.h"
+#include "hmindex.h"
+#include "surrogate.h"
+#include "runstats.h"
+#include "trace.h"
 #include "../interpreter/evaluator.h"
 
 namespace hsl {
@@ -12,30 +22,177 @@ namespace hsl {
     struct Harmony {
         std::vector<double> vars;
         double value;
+        double violation = 0.0; // 제약 위반 정도 (0: 실행 가능)
         bool operator<(const Harmony& other) const { return value < other.value; }
         bool operator>(const Harmony& other) const { return value > other.value; }
         bool operator==(const Harmony& other) const { return vars == other.vars && value == other.value; }
     };
 
+    // 최적화가 멈춘 이유
+    enum class StopReason { MaxImp, Target, Stall, Spread, TimeLimit };
+    const char* stopReasonName(StopReason r);
+
+    // 실행 통계
+    struct HSStats {
+        std::uint64_t evaluations = 0;   // 목적 함수 실제 호출 수
+        std::uint64_t cacheLookups = 0;
+        std::uint64_t cacheHits = 0;
+        std::uint64_t earlyAborts = 0;   // cutoff로 중단된 목적 함수 평가 수 (evaluations에 포함)
+        std::uint64_t bestFoundAt = 0;   // 최종 최적 해를 찾은 시점의 평가 수
+        StopReason stopReason = StopReason::MaxImp;
+        unsigned int stopIteration = 0;  // 멈춘 시점까지 수행한 반복 수
+        int restarts = 0;
+        std::uint64_t initSamples = 0;   // 초기화(재시작 포함)에 뽑은 표본 수
+        std::uint64_t infeasible = 0;    // 제약을 위반한 후보 수
+        std::uint64_t firstFeasibleAt = 0; // 처음 실행 가능 해가 나온 후보 번호 (초기 표본 포함, 0: 없음)
+        std::uint64_t repairAttempts = 0;  // 보정 단계에 들어간 위반 후보 수
+        std::uint64_t repairSuccesses = 0; // 그중 실행 가능해진 수
+        std::uint64_t duplicatesSkipped = 0; // HM에 이미 있는 즉흥 연주라 평가를 생략한 수
+        std::uint64_t surrogateSkipped = 0;  // 대리 모델 예측이 HM worst를 못 이겨 평가를 생략한 수
+        std::uint64_t surrogateChecked = 0;  // 예측한 뒤 실제로도 평가한 후보 수
+        std::uint64_t surrogateAgreed = 0;   // 그중 예측과 실제 값의 판정(HM worst를 이기는지)이 같았던 수
+        [[nodiscard]] double cacheHitRate() const {
+            return cacheLookups ? static_cast<double>(cacheHits) / static_cast<double>(cacheLookups) : 0.0;
+        }
+    };
+
     struct HSResult {
         std::vector<double> vars;
         double value = 0.0;
         double cpu_time = 0.0;
+        HSStats stats;
+        RunCounters counters; // Stats일 때만 채워짐
+    };
+
+    // SGHS가 학습하는 파라미터 상태
+    struct AdaptiveState {
+        double HMCRm = 0.98;
+        double PARm = 0.9;
+        std::vector<double> goodHMCR; // 이번 학습 주기에 HM 교체에 성공한 즉흥 연주의 값들
+        std::vector<double> goodPAR;
+    };
+
+    struct Checkpoint;
+
+    // 최적화 엔진 공통 인터페이스. 모든 엔진은 같은 HSProblem(컴파일된 모델)을 푼다 (Engine 파라미터)
+    class Solver {
+    public:
+        virtual ~Solver() = default;
+        virtual Harmony optimize() = 0;
+        [[nodiscard]] virtual const HSStats& stats() const = 0;
+        // Stats일 때 모든 스레드의 계수기 합 (꺼져 있으면 enabled = false)
+        [[nodiscard]] virtual RunCounters counters() const { return {}; }
     };
 
-    class HarmonySearch {
+    class HarmonySearch : public Solver {
     public:
         HarmonySearch(const HSProblem& prob, const HSParams& params,
                       unsigned int seed = std::random_device{}());
-        Harmony optimize();
+        Harmony optimize() override;
+        [[nodiscard]] const HSStats& stats() const override { return statistics; }
+        [[nodiscard]] RunCounters counters() const override;
+        [[nodiscard]] const std::vector<Harmony>& memory() const { return HM; }
+        // 다음 optimize()의 초기 HM 후보. WarmStart 파일의 해와 같은 규칙으로 다시 평가해 받아들인다
+        void presetMemory(std::vector<std::vector<double>> vectors) { presets = std::move(vectors); }
+        // 포트폴리오 에포크용. 처음이면 optimize()처럼 시작하고, 이후에는 멈춘 반복에서 HM과 상태를 그대로 이어
+        // 반복 until까지 진행한다. IHS/SGHS 일정과 재시작의 기준은 그대로 MaxImp
+        Harmony advance(unsigned int until);
+        // 다른 엔진이 찾은 해를 평가 없이 HM에 넣는다 (worst보다 나을 때). advance 사이에 부른다
+        void inject(const Harmony& h);
+        // 지금까지 소모한 후보 수 (평가한 후보와 중복으로 건너뛴 즉흥 연주)
+        [[nodiscard]] std::uint64_t candidates() const { return evalCount + statistics.duplicatesSkipped; }
+        // advance로 진행한 반복 수
+        [[nodiscard]] unsigned int iteration() const { return progress.iteration; }
     private:
         const HSProblem& problem;
         HSParams params;
+        std::ostream silent{nullptr};    // Quiet일 때의 출력 (버림)
+        std::ostream& out;
         std::mt19937 rng;
+        std::uint64_t seed;
+        std::uint64_t evalCount = 0; // 후보 번호. 목적 함수의 난수 스트림은 (seed, 후보 번호)에서 파생
         std::vector<Harmony> HM;
-        Harmony generateFeasibleSolution();
-        double evaluate(const std::vector<double>& solution);
-        void insertHarmony(const Harmony& h);
+        HSStats statistics;
+        std::unique_ptr<EvalCache> cache;
+        bool dedup;                      // Dedup (난수를 쓰는 모델이면 끔: 같은 해도 평가마다 값이 다름)
+        HarmonyIndex index;              // HM 멤버의 해시 색인 (중복 검출, 서로 다른 멤버 수)
+        std::unique_ptr<Surrogate> surrogate; // Surrogate: 평가 전 선별용 대리 모델
+        std::unique_ptr<CounterSet> counterSet; // Stats: 스레드별 계수기
+        std::unique_ptr<TraceWriter> trace;     // Trace: 수렴 기록 (optimize 동안만)
+        struct Moments {                 // Trace: HM 통계를 교체마다 O(n)으로 갱신
+            std::vector<double> sum, sumSq; // 변수별, 범위로 [0,1]에 정규화한 값
+            double valueSum = 0.0;
+            long finite = 0;             // 유한한 목적 값의 수
+            unsigned int updates = 0;    // 마지막으로 다시 계산한 뒤의 교체 수
+        } moments;
+        AdaptiveState adaptive;
+        double penaltyWeight = 0.0;      // Static/Adaptive 현재 가중치
+        unsigned int penaltyRun = 0;     // Adaptive: 최적 해의 실행 가능 여부가 연속으로 같았던 반복 수
+        bool penaltyRunFeasible = false;
+        double epsilon0 = 0.0;           // Epsilon: 초기 ε과 현재 ε
+        double epsilon = 0.0;
+        std::vector<double> constraintScratch; // 보정 단계의 제약별 위반 크기
+        std::vector<double> spread;      // Bandwidth = Spread: 변수별 HM 표준편차
+        bool spreadStale = true;         // HM이 바뀌어 spread를 다시 계산해야 하는지
+        double lastHMCR = 0.0, lastPAR = 0.0; // 마지막 즉흥 연주에 쓴 HMCR/PAR (SGHS 학습용)
+        struct Progress {                // 마지막 run이 멈춘 지점 (반복 루프의 지역 상태, advance가 이어감)
+            bool started = false;
+            unsigned int iteration = 0;
+            unsigned int lastImprovement = 0;
+            unsigned int lastRestart = 0;
+            Harmony incumbent{};
+            std::chrono::steady_clock::time_point start;
+        } progress;
+        // objectiveBatch로 한 번에 평가한 뒤 반복마다 하나씩 HM에 반영할 후보
+        struct Pending {
+            Harmony h;
+            bool duplicate;
+            double HMCR, PAR;
+            bool predicted = false;      // 대리 모델로 예측했는지 (예측 값, 그때의 cutoff)
+            double prediction = 0.0, cutoff = 0.0;
+        };
+        std::vector<Harmony> initialHarmonies(std::size_t count);
+        std::vector<std::vector<double>> presets;
+        std::vector<Harmony> admitHarmonies(std::vector<std::vector<double>> vectors, std::size_t count,
+                                            const std::string& source);
+        double violationOf(const std::vector<double>& solution, std::uint64_t stream) const;
+        RunCounters* tally() const { return counterSet ? &counterSet->local() : nullptr; }
+        void countCheck(const std::vector<double>& solution, std::uint64_t stream, double violation);
+        void improvise(std::vector<double>& newVars, unsigned int iter);
+        void improviseBatch(unsigned int iter, std::size_t count, std::deque<Pending>& queue);
+        double bandwidth(std::size_t i, double ratio);
+        double pitchAdjust(std::size_t i, double x, double bw);
+        void reindex();
+        void traceRebuild();
+        void traceAdd(const Harmony& h, double sign);
+        void traceReplace(const Harmony& removed, const Harmony& added);
+        void tracePoint(unsigned int iter, const Harmony& incumbent, std::chrono::steady_clock::time_point start);
+        const Harmony& best() const;
+        std::size_t worstIndex() const;
+        bool precedes(const Harmony& a, const Harmony& b) const;
+        bool needsObjective(double violation) const;
+        double objectiveCutoff(double violation, const Harmony& rival) const;
+        void completeObjectives();
+        void updateConstraintHandling(unsigned int iter);
+        unsigned int restartMemory(unsigned int remaining);
+        bool shouldStop(unsigned int iter, const Harmony& incumbent, unsigned int lastImprovement,
+                        std::chrono::steady_clock::time_point start);
+        std::uint64_t nextStream();
+        void evaluate(Harmony& h, std::uint64_t stream, const Harmony* rival, bool& aborted,
+                      bool violationKnown = false);
+        void repairCandidate(Harmony& h, std::uint64_t stream);
+        bool screenOut(const Harmony& h, std::uint64_t stream, double cutoff, bool& predicted, double& prediction);
+        void learn(const Harmony& h, bool predicted, double prediction, double cutoff);
+        void feedSurrogate(const std::vector<double>& x, double y);
+        double resampleVariable(std::size_t i);
+        void evaluateCandidate(Harmony& h);
+        double invalidValue() const;
+        double worstValue() const;
+        bool insertHarmony(const Harmony& h);
+        void saveState(Checkpoint& cp, unsigned int iter, unsigned int lastImprovement, unsigned int lastRestart,
+                       const Harmony& incumbent, double elapsed) const;
+        void restoreState(const Checkpoint& cp);
+        Harmony run(unsigned int until);
     };
 
     HSResult runHarmonySearch(const HSProblem& prob, const HSParams& params,
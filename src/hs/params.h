@@ -1,18 +1,131 @@
 #ifndef HSL_PARAMS_
 #define HSL_PARAMS_
 #include <string>
+#include <limits>
+#include <vector>
 
 namespace hsl{
 
+    // 즉흥 연주 방식
+    //  HS   : 고정 HMCR/PAR/대역폭 (기본)
+    //  IHS  : Improved HS - PAR은 PARmin->PARmax로 선형 증가, 대역폭은 BWmax->BWmin으로 지수 감소
+    //  GHS  : Global-best HS - 음정 조정 시 현재 최적 해의 임의 성분을 가져옴
+    //  SGHS : Self-adaptive GHS - 성공한 즉흥 연주의 HMCR/PAR 평균을 LP 주기마다 학습
+    enum class HSVariant { HS, IHS, GHS, SGHS };
+
+    // 제약 처리 방식 (위반 정도 = 각 제약의 max(0, lhs - rhs), 등식은 |lhs - rhs| 의 합)
+    //  Reject   : 위반한 후보는 버림
+    //  Static   : 목적 값에 PenaltyWeight * 위반 정도를 더해(최대화는 빼서) 비교
+    //  Adaptive : Static과 같되, 최적 해가 계속 실행 가능하면 가중치를 줄이고 계속 위반이면 늘림
+    //  Epsilon  : 위반 정도가 ε 이하인 해끼리는 목적 값으로 비교. ε은 초기 HM에서 정하고 반복에 따라 0으로 줄임
+    //  Deb      : 실행 가능 해 > 위반 해, 둘 다 위반이면 위반 정도가 작은 쪽 (기본)
+    enum class ConstraintMode { Reject, Static, Adaptive, Epsilon, Deb };
+
+    // 위반 후보 보정 단계. 즉흥 연주 직후 평가 전에 나열 순서대로 적용하고, 위반 정도를 줄인 변경만 남긴다
+    //  Clamp    : 변수 범위로 자르고 int 변수는 반올림
+    //  Resample : 위반한 제약에 나타나는 변수만 HMCR/PAR 규칙으로 다시 뽑기 (RepairTries회)
+    //  Greedy   : 위반한 제약의 변수를 한 칸(int: 1 이상, any: 범위/N_Seg)씩 움직여 보기 (RepairTries바퀴)
+    enum class RepairStage { Clamp, Resample, Greedy };
+
+    // [VAR]에 bw가 없는 변수의 음정 조정 대역폭
+    //  Range  : 범위/N_Seg (IHS/SGHS는 범위 * BWmax->BWmin 일정) (기본)
+    //  Spread : HM에서 그 변수 값의 표준편차 (최소 범위*BWmin). IHS/SGHS는 같은 일정 비율로 줄임
+    enum class BandwidthMode { Range, Spread };
+
+    // 최적화 엔진. HS 외의 엔진은 제약을 Deb 규칙으로만 다루고 MaxImp를 후보 수로 센다
+    //  HS        : 하모니 서치 (Variant로 변형 선택) (기본)
+    //  DE        : 차분 진화 (rand/1/bin)
+    //  PSO       : 입자 군집 최적화
+    //  CMAES     : CMA-ES (변수 100개 초과면 대각 공분산)
+    //  Pattern   : 좌표 패턴 탐색
+    //  Portfolio : 위 다섯 엔진을 함께 돌리며 최적 해를 공유하고, 빨리 개선하는 엔진에 예산을 더 줌
+    enum class SolverEngine { HS, DE, PSO, CMAES, Pattern, Portfolio };
+
     struct HSParams {
         int HMS = 30;
         double HMCR = 0.95;
         double PAR = 0.7;
         unsigned int MaxImp = 30000;
         int N_Seg = 300;
+        long CacheSize = -1; // 평가 캐시 항목 수. -1: 자동(작은 정수 정의역일 때만), 0: 끔
+        bool EarlyAbort = true; // HM worst보다 나아질 수 없는 후보의 평가 조기 중단
+
+        SolverEngine Engine = SolverEngine::HS;
+        unsigned int PopSize = 0;            // DE/PSO/CMA-ES 개체 수 (0: 엔진별 기본값)
+
+        HSVariant Variant = HSVariant::HS;
+        double PARmin = 0.35, PARmax = 0.99; // IHS, GHS
+        double BWmin = 1e-4, BWmax = 0.05;   // IHS, SGHS (변수 범위 대비 비율)
+        int LP = 100;                        // SGHS 학습 주기
+        BandwidthMode Bandwidth = BandwidthMode::Range;
+
+        // 중복 해 배제. 켜면 HM 멤버와 같은(DedupTol > 0이면 범위*DedupTol 칸 안의) 후보는 평가하지 않고 HM에도 넣지 않음.
+        // 끄면 HM 값만으로 조합된 후보가 멤버와 정확히 같을 때만 평가를 건너뜀
+        bool Dedup = false;
+        double DedupTol = 0.0;
+
+        // 종료 조건 (MaxImp 외). 0 또는 NaN이면 사용하지 않음
+        double Target = std::numeric_limits<double>::quiet_NaN(); // 최적 값이 이 값에 도달하면 종료
+        unsigned int StallWindow = 0;  // 이 반복 수 동안 최적 값이 개선되지 않으면 종료
+        double SpreadEps = 0.0;        // |worst - best| / max(|best|, 1) 가 이 값 미만이면 종료
+        double TimeLimit = 0.0;        // 벽시계 시간 한도 (초)
+
+        ConstraintMode Constraints = ConstraintMode::Deb;
+        double PenaltyWeight = 1e3;     // Static/Adaptive 위반 정도 가중치 (Adaptive는 초기값)
+        std::vector<RepairStage> Repair = {RepairStage::Clamp, RepairStage::Resample, RepairStage::Greedy};
+        int RepairTries = 3;
+        double EqTolerance = 1e-9;      // |l - r|이 이 값 미만이면 등식 만족 (닫힌 형태로 풀 수 없는 등식용)
+
+        unsigned long InitBudget = 0;   // 초기 HM을 채우기 위해 뽑을 최대 표본 수 (0: max(HMS*200, 10000))
+
+        bool Quiet = false;             // 진행률과 [INFO]/[WARN] 출력 끔
+        // 수렴 기록 (반복, 평가 수, 경과 시간, best, worst, HM 평균, 다양성). 경로가 비어 있으면 기록하지 않음.
+        // ".bin"으로 끝나면 이진, 아니면 CSV. TraceInterval > 0이면 시간 간격, 아니면 TraceEvery 반복마다
+        std::string Trace;
+        unsigned int TraceEvery = 100;
+        double TraceInterval = 0.0;     // 초
+        bool Stats = false;             // 핫 경로 계수기 (HM 교체, 변수 출처, [ST]별 위반, 구간별 시간). HSResult::counters
+        unsigned int ProfileModel = 0;  // 모델 프로파일: 평가 N번 중 1번을 식 노드별로 시간 잼 (0: 끔). HSProblem::profiler
+
+        // 이전 실행의 해(체크포인트 또는 CSV)로 초기 HM 일부를 채움. 비어 있으면 사용하지 않음
+        std::string WarmStart;
+
+        // 체크포인트. Checkpoint 경로가 비어 있으면 기록하지 않음
+        std::string Checkpoint;
+        unsigned int CheckpointEvery = 100000; // 이 반복 수마다 스냅숏 (기록은 백그라운드)
+        bool Resume = false;                    // Checkpoint 파일이 있으면 거기서 이어서 실행
+
+        // 협력 공진화. 목적식의 항/제약이 함께 쓰는 변수끼리 묶고, 묶음마다 나머지 변수를 고정한 HS를 돌린다
+        bool Decompose = false;
+        int GroupSize = 10;             // 묶음의 최대 변수 수 (더 큰 연결 성분은 나눠서 번갈아 최적화)
+        int CCRounds = 0;               // 모든 묶음을 한 번씩 도는 횟수 (0: 묶음끼리 독립이면 1, 아니면 10)
+
+        // 대리 모델 선별. 평가한 해에 맞춘 RBF 모델의 예측이 HM worst를 못 이기는 후보는 목적 함수를 부르지 않음
+        bool Surrogate = false;
+        unsigned int SurrogateSize = 0; // 모델을 맞출 최근 평가 해의 수 (0: 변수 수*5, 50..500)
+        double SurrogateExplore = 0.1;  // 버릴 후보 중 그래도 평가하는 비율 (모델 검증/보관소 갱신용)
+
+        // [OBJ] ... external "명령"의 작업자 프로세스
+        unsigned int Workers = 0;       // 작업자 수 (0: 하드웨어 스레드 수)
+        unsigned int InFlight = 2;      // 작업자마다 미리 보내 두는 요청 수
+        double EvalTimeout = 0.0;       // 평가 하나의 시간 한도 (초, 0: 없음). 넘으면 작업자를 다시 띄우고 그 후보는 버림
+
+        // 정체 시 재시작 (IPOP 방식). 최적 해는 유지하고 HM을 다시 채우며, 재초기화 평가도 MaxImp 예산에서 차감
+        int Restarts = 0;               // 최대 재시작 횟수 (0: 끔)
+        unsigned int RestartStall = 0;  // 이 반복 수 동안 개선이 없으면 재시작 (0: MaxImp/20)
+        double RestartHMSFactor = 2.0;  // 재시작마다 HMS 배율
     };
 
     HSParams loadParams(const std::string& filename);
+    bool parseVariant(const std::string& name, HSVariant& out);
+    const char* variantName(HSVariant v);
+    bool parseEngine(const std::string& name, SolverEngine& out);
+    const char* engineName(SolverEngine e);
+    bool parseConstraintMode(const std::string& name, ConstraintMode& out);
+    const char* constraintModeName(ConstraintMode m);
+    bool parseBandwidthMode(const std::string& name, BandwidthMode& out);
+    // "Clamp+Resample+Greedy" 꼴 (쉼표/공백 구분도 허용), "None"이면 빈 목록
+    bool parseRepairStages(const std::string& list, std::vector<RepairStage>& out);
     void editParams(HSParams& param, int HMS, double HMCR, double PAR, unsigned int maxiter);
 }
 #endif
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include "portfolio.h"
+#include "engines.h"
+#include "io.h"
+#include "../utils/threadpool.h"
+
+namespace hsl {
+
+    namespace {
+        // HS 어댑터. HarmonySearch 하나를 에포크마다 멈춘 반복에서 이어 돌린다 (HM, 캐시, IHS/SGHS 일정이 유지됨).
+        // 받은 최적 해는 평가 없이 HM에 넣고, 예산은 HS가 실제로 소모한 후보 수(초기 HM과 재시작 표본 포함)로 센다
+        class HarmonyEngine : public StepSolver {
+        public:
+            HarmonyEngine(const HSProblem& prob, const HSParams& params, unsigned int seed)
+                    : StepSolver(prob, params, seed, "HS") {
+                HSParams sub = params;
+                sub.Quiet = true;
+                sub.Checkpoint.clear();
+                sub.Trace.clear();
+                sub.Resume = false;
+                hs = std::make_unique<HarmonySearch>(prob, sub, seed);
+            }
+
+            bool advance(std::uint64_t budget) override {
+                const std::uint64_t spent = hs->candidates();
+                const auto until = static_cast<unsigned int>(
+                        std::min<std::uint64_t>(params.MaxImp, hs->iteration() + std::max<std::uint64_t>(1, budget)));
+                Harmony h = hs->advance(until);
+
+                const HSStats& s = hs->stats();
+                evalCount += hs->candidates() - spent;
+                statistics.evaluations = s.evaluations;
+                statistics.infeasible = s.infeasible;
+                statistics.initSamples = s.initSamples;
+                statistics.restarts = s.restarts;
+                if (better(h, bestSoFar)) bestSoFar = h;
+                if (s.stopReason == StopReason::Target || s.stopReason == StopReason::TimeLimit) {
+                    statistics.stopReason = s.stopReason;
+                    return false;
+                }
+                return true;
+            }
+
+            void inject(const Harmony& h) override {
+                StepSolver::inject(h);
+                hs->inject(h);
+            }
+
+            [[nodiscard]] RunCounters counters() const override { return hs->counters(); }
+
+        private:
+            std::unique_ptr<HarmonySearch> hs;
+
+            void initialize() override {}
+            void step() override {}
+        };
+
+        constexpr double minShare = 0.05;
+    }
+
+    RunCounters PortfolioSolver::counters() const {
+        RunCounters total;
+        for (const auto& e : engines) total.merge(e->counters());
+        return total;
+    }
+
+    PortfolioSolver::PortfolioSolver(const HSProblem& prob, const HSParams& params, unsigned int seed)
+            : problem(prob), params(params), out(params.Quiet ? silent : hsl::cout) {
+        auto sub = [&](std::uint64_t k) { return static_cast<unsigned int>(deriveStream(seed, k)); };
+        engines.push_back(std::make_unique<HarmonyEngine>(prob, params, sub(0)));
+        engines.push_back(std::make_unique<DifferentialEvolution>(prob, params, sub(1)));
+        engines.push_back(std::make_unique<ParticleSwarm>(prob, params, sub(2)));
+        engines.push_back(std::make_unique<CMAES>(prob, params, sub(3)));
+        engines.push_back(std::make_unique<PatternSearch>(prob, params, sub(4)));
+        shares.assign(engines.size(), 1.0 / static_cast<double>(engines.size()));
+    }
+
+    PortfolioSolver::~PortfolioSolver() = default;
+
+    Harmony PortfolioSolver::optimize() {
+        const int barWidth = 50;
+        const std::size_t K = engines.size();
+        out << "[INFO] Optimization started... (Portfolio:";
+        for (const auto& e : engines) out << ' ' << e->name();
+        out << ")" << std::endl;
+
+        const StepSolver& judge = *engines.front();
+        Harmony best{{}, 0.0, std::numeric_limits<double>::infinity()};
+        const char* finder = nullptr;
+        std::uint64_t used = 0;
+        const std::uint64_t epoch = std::max<std::uint64_t>(params.MaxImp / 20, 500);
+        std::vector<std::uint64_t> budgets(K), before(K);
+        std::vector<char> more(K);
+        std::vector<double> rates(K);
+        bool running = true;
+
+        while (running && used < params.MaxImp) {
+            const std::uint64_t slice = std::min<std::uint64_t>(epoch, params.MaxImp - used);
+            for (std::size_t k = 0; k < K; ++k) {
+                budgets[k] = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::llround(shares[k] * slice)));
+                before[k] = engines[k]->candidates();
+            }
+            auto run = [&](std::size_t k) { more[k] = engines[k]->advance(budgets[k]); };
+            if (problem.parallelSafe) ThreadPool::shared().parallelFor(K, run);
+            else for (std::size_t k = 0; k < K; ++k) run(k);
+
+            // 에포크 시작 때 모든 엔진의 최적 해는 best였으므로, best보다 나아진 만큼이 그 엔진의 개선량
+            const Harmony previous = best;
+            double total = 0.0;
+            for (std::size_t k = 0; k < K; ++k) {
+                const Harmony& h = engines[k]->incumbent();
+                const std::uint64_t spent = engines[k]->candidates() - before[k];
+                used += spent;
+                double gain = 0.0;
+                if (judge.better(h, previous)) {
+                    if (previous.violation > 0.0) gain = h.violation == 0.0 ? 1.0 : previous.violation - h.violation;
+                    else gain = std::abs(h.value - previous.value) / std::max(std::abs(previous.value), 1e-12);
+                    if (!std::isfinite(gain)) gain = 1.0; // 첫 에포크 (이전 최적 해 없음)
+                }
+                rates[k] = spent ? gain / static_cast<double>(spent) : 0.0;
+                total += rates[k];
+                if (judge.better(h, best)) {
+                    best = h;
+                    finder = engines[k]->name();
+                }
+                if (!more[k]) running = false;
+            }
+            std::uint64_t evaluations = 0;
+            for (const auto& e : engines) evaluations += e->stats().evaluations;
+            if (judge.better(best, previous)) statistics.bestFoundAt = evaluations;
+            if (!statistics.firstFeasibleAt && best.violation == 0.0) statistics.firstFeasibleAt = used;
+
+            // 몫: 이전 몫과 이번 개선 비율의 평균, 최소 minShare
+            if (total > 0.0) {
+                double sum = 0.0;
+                for (std::size_t k = 0; k < K; ++k) {
+                    shares[k] = std::max(minShare, 0.5 * shares[k] + 0.5 * rates[k] / total);
+                    sum += shares[k];
+                }
+                for (auto& s : shares) s /= sum;
+            }
+            for (auto& e : engines) e->inject(best);
+
+            float progress = std::min(1.0f, static_cast<float>(used) / static_cast<float>(params.MaxImp));
+            int pos = static_cast<int>(barWidth * progress);
+            out << "\r[";
+            for (int i = 0; i < barWidth; ++i) out << (i < pos ? "#" : "-");
+            out << "] " << std::setw(3) << int(progress * 100.0f) << "%   " << std::flush;
+        }
+        out << std::endl;
+
+        for (const auto& e : engines) {
+            const HSStats& s = e->stats();
+            statistics.evaluations += s.evaluations;
+            statistics.infeasible += s.infeasible;
+            statistics.initSamples += s.initSamples;
+            statistics.restarts += s.restarts;
+            if (s.stopReason != StopReason::MaxImp) statistics.stopReason = s.stopReason;
+        }
+        statistics.stopIteration = static_cast<unsigned int>(std::min<std::uint64_t>(used, params.MaxImp));
+        if (statistics.stopReason != StopReason::MaxImp)
+            out << "[INFO] Stopped early (" << stopReasonName(statistics.stopReason) << ") at candidate " << used << std::endl;
+        out << "[INFO] Portfolio shares:";
+        for (std::size_t k = 0; k < K; ++k)
+            out << ' ' << engines[k]->name() << ' ' << std::fixed << std::setprecision(0) << shares[k] * 100.0 << '%';
+        out << std::defaultfloat << std::setprecision(6);
+        if (finder) out << "; best found by " << finder << " after " << statistics.bestFoundAt << " evaluations";
+        out << std::endl;
+        if (best.violation > 0.0)
+            out << "[WARN] No feasible solution found; the best one violates the constraints by "
+                << best.violation << std::endl;
+        return best;
+    }
+
+}
@@ -0,0 +1,36 @@
+#ifndef HSL_PORTFOLIO_
+#define HSL_PORTFOLIO_
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <ostream>
+#include "solver.h"
+
+namespace hsl {
+
+    // 포트폴리오 (Engine = Portfolio). HS, DE, PSO, CMA-ES, 패턴 탐색을 같은 문제에 함께 돌린다.
+    // 예산을 에포크(max(MaxImp/20, 500) 후보)로 나눠 엔진마다 몫만큼 진행하고(병렬 평가가 안전하면 스레드 풀에서 동시에),
+    // 에포크가 끝나면 전체 최적 해를 모든 엔진에 넣어 준다. 몫은 후보당 개선량에 비례하도록 매 에포크 옮기되
+    // 엔진마다 5%는 남겨 둔다. 스레드 풀은 후보 단위로 일을 나누므로 몫이 큰 엔진이 그만큼 많은 코어를 쓴다
+    class PortfolioSolver : public Solver {
+    public:
+        PortfolioSolver(const HSProblem& prob, const HSParams& params, unsigned int seed);
+        ~PortfolioSolver() override;
+        Harmony optimize() override;
+        [[nodiscard]] const HSStats& stats() const override { return statistics; }
+        [[nodiscard]] RunCounters counters() const override;
+
+    private:
+        const HSProblem& problem;
+        HSParams params;
+        std::ostream silent{nullptr};
+        std::ostream& out;
+        std::vector<std::unique_ptr<StepSolver>> engines;
+        std::vector<double> shares;
+        HSStats statistics;
+    };
+
+}
+
+#endif
@@ -2,11 +2,17 @@
 #include <sstream>
 #include <stdexcept>
 #include <iostream>
+#include <memory>
 
 #include "../interpreter/lexer.h"
 #include "../interpreter/parser.h"
 #include "params.h"
 #include "hsalgorithm.h"
+#include "coevolution.h"
+#include "engines.h"
+#include "portfolio.h"
+#include "external.h"
+#include "io.h"
 #include "runner.h"
 
 namespace hsl {
@@ -18,20 +24,76 @@ namespace hsl {
         return ss.str();
     }
 
+    // [OBJ] ... external: 외부 평가기를 붙인 문제 사본. 평가기는 사본의 함수들이 공유하며 마지막 사본과 함께 정리된다
+    static HSProblem attachExternal(const HSProblem& prob, const HSParams& params,
+                                    std::shared_ptr<ExternalEvaluator>& evaluator) {
+        evaluator = std::make_shared<ExternalEvaluator>(prob.externalCommand, prob.variables.size(),
+                                                        params.Workers, params.InFlight, params.EvalTimeout);
+        HSProblem ext = prob;
+        ext.objectiveBatch = [evaluator](const std::vector<std::vector<double>>& points,
+                                         const std::vector<std::uint64_t>& streams, std::vector<double>& values) {
+            evaluator->evaluate(points, streams, values);
+        };
+        ext.objectiveSeeded = [evaluator](const std::vector<double>& x, std::uint64_t stream) {
+            std::vector<double> value;
+            evaluator->evaluate({x}, {stream}, value);
+            return value[0];
+        };
+        ext.objective = [f = ext.objectiveSeeded](const std::vector<double>& x) { return f(x, 0); };
+        ext.batchSize = evaluator->capacity();
+        ext.parallelSafe = false; // 평가기는 파이프 상태를 가지므로 한 스레드에서만
+        return ext;
+    }
+
+    static void reportExternal(const ExternalEvaluator& evaluator, const HSParams& params) {
+        if (params.Quiet) return;
+        const auto& c = evaluator.counters();
+        hsl::cout << "[INFO] External objective: " << c.evaluations << " evaluations on "
+                  << evaluator.workerCount() << (evaluator.workerCount() == 1 ? " worker" : " workers") << std::endl;
+        if (c.failures || c.crashes) {
+            hsl::cout << "[WARN] External objective: " << c.failures << " failed evaluations ("
+                      << c.timeouts << " timed out), " << c.timeouts + c.crashes << " worker restarts" << std::endl;
+        }
+    }
+
+    std::unique_ptr<Solver> makeSolver(const HSProblem& prob, const HSParams& params, unsigned int seed) {
+        if (!params.Trace.empty() && (params.Decompose || params.Engine != SolverEngine::HS) && !params.Quiet)
+            hsl::cout << "[WARN] Trace records the HS loop only; it is ignored with "
+                      << (params.Decompose ? "Decompose" : engineName(params.Engine)) << "." << std::endl;
+        if (params.Decompose) {
+            if (params.Engine != SolverEngine::HS && !params.Quiet)
+                hsl::cout << "[WARN] Decompose runs HS on each group; Engine = " << engineName(params.Engine)
+                          << " is ignored." << std::endl;
+            return std::make_unique<CooperativeSearch>(prob, params, seed);
+        }
+        switch (params.Engine) {
+            case SolverEngine::DE: return std::make_unique<DifferentialEvolution>(prob, params, seed);
+            case SolverEngine::PSO: return std::make_unique<ParticleSwarm>(prob, params, seed);
+            case SolverEngine::CMAES: return std::make_unique<CMAES>(prob, params, seed);
+            case SolverEngine::Pattern: return std::make_unique<PatternSearch>(prob, params, seed);
+            case SolverEngine::Portfolio: return std::make_unique<PortfolioSolver>(prob, params, seed);
+            case SolverEngine::HS: break;
+        }
+        return std::make_unique<HarmonySearch>(prob, params, seed);
+    }
+
     Harmony runHarmonySearch(const HSProblem& prob, const HSParams& params, unsigned int seed) {
-        HarmonySearch hs(prob, params, seed);
-        return hs.optimize();
+        if (!prob.externalCommand.empty() && !prob.objectiveBatch) {
+            std::shared_ptr<ExternalEvaluator> evaluator;
+            HSProblem ext = attachExternal(prob, params, evaluator);
+            Harmony best = runHarmonySearch(ext, params, seed);
+            reportExternal(*evaluator, params);
+            return best;
+        }
+        return makeSolver(prob, params, seed)->optimize();
     }
 
     Harmony runHarmonySearch(Program* program, const HSParams& params, unsigned int seed) {
-        HSProblem prob = buildHSProblem(program);
+        HSProblem prob = buildHSProblem(program, params.EqTolerance, params.Decompose, params.ProfileModel);
         return runHarmonySearch(prob, params, seed);
     }
 
-    Harmony runHarmonySearchFromFile(const std::string& hsFilePath,
-                                     const HSParams& params,
-                                     unsigned int seed,
-                                     std::vector<std::string>* parseErrors) {
+    static Program* parseFile(const std::string& hsFilePath, std::vector<std::string>* parseErrors) {
         std::string src = readAll(hsFilePath);
 
         hsl::Lexer lex(src);
@@ -52,8 +114,18 @@ namespace hsl {
             for (const auto& e : errs) msg << "  - " << e << "\n";
             throw std::runtime_error(msg.str());
         }
+        return program;
+    }
+
+    Harmony runHarmonySearchFromFile(const std::string& hsFilePath,
+                                     const HSParams& params,
+                                     unsigned int seed,
+                                     std::vector<std::string>* parseErrors) {
+        return runHarmonySearch(parseFile(hsFilePath, parseErrors), params, seed);
+    }
 
-        return runHarmonySearch(program, params, seed);
+    HSProblem loadHSProblem(const std::string& hsFilePath, const HSParams& params) {
+        return buildHSProblem(parseFile(hsFilePath, nullptr), params.EqTolerance, params.Decompose, params.ProfileModel);
     }
 
     HSResult runHarmonySearch(const HSProblem& prob,
@@ -61,17 +133,27 @@ namespace hsl {
                           unsigned int seed,
                           std::ostream& log)
     {
+    if (!prob.externalCommand.empty() && !prob.objectiveBatch) {
+        std::shared_ptr<ExternalEvaluator> evaluator;
+        HSProblem ext = attachExternal(prob, params, evaluator);
+        HSResult result = runHarmonySearch(ext, params, seed, log);
+        reportExternal(*evaluator, params);
+        return result;
+    }
+
     auto start = std::chrono::high_resolution_clock::now();
-    HarmonySearch hs(prob, params, seed);
+    HSResult result;
 
     log << "[HS-L] Optimization started..." << std::endl;
-    Harmony best = hs.optimize();
+    auto solver = makeSolver(prob, params, seed);
+    Harmony best = solver->optimize();
+    result.stats = solver->stats();
+    result.counters = solver->counters();
     log << "[HS-L] Optimization finished." << std::endl;
 
     auto end = std::chrono::high_resolution_clock::now();
     double elapsed = std::chrono::duration<double>(end - start).count();
 
-    HSResult result;
     result.value = best.value;
     result.vars = best.vars;
     result.cpu_time = elapsed;
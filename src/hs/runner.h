@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <memory>
 #include "../interpreter/ast.h"
 #include "../interpreter/evaluator.h"
 #include "hsalgorithm.h"
@@ -11,6 +12,9 @@
 
 namespace hsl {
 
+    // params.Engine(Decompose면 협력 공진화)에 맞는 엔진
+    std::unique_ptr<Solver> makeSolver(const HSProblem& prob, const HSParams& params, unsigned int seed);
+
     // 1) 이미 AST(Program*)가 있는 경우: evaluator → HS 실행
     Harmony runHarmonySearch(Program* program, const HSParams& params, unsigned int seed);
 
@@ -29,6 +33,9 @@ namespace hsl {
                                      const HSParams& params,
                                      unsigned int seed = std::random_device{}(),
                                      std::vector<std::string>* parseErrors = nullptr);
+
+    // 4) .hs 파일 → HSProblem (실행하지 않음). 파싱 에러는 예외
+    HSProblem loadHSProblem(const std::string& hsFilePath, const HSParams& params);
 }
 
 #endif
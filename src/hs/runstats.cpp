@@ -0,0 +1,194 @@
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+#include <cstdio>
+#include "runstats.h"
+#include "hsalgorithm.h"
+
+namespace hsl {
+
+    void RunCounters::merge(const RunCounters& other) {
+        enabled |= other.enabled;
+        improvisations += other.improvisations;
+        fromMemory += other.fromMemory;
+        fromPitch += other.fromPitch;
+        fromRandom += other.fromRandom;
+        replacements += other.replacements;
+        checked += other.checked;
+        feasible += other.feasible;
+        if (rejections.size() < other.rejections.size()) rejections.resize(other.rejections.size(), 0);
+        for (std::size_t i = 0; i < other.rejections.size(); ++i) rejections[i] += other.rejections[i];
+        improviseNs += other.improviseNs;
+        penaltyNs += other.penaltyNs;
+        objectiveNs += other.objectiveNs;
+        insertNs += other.insertNs;
+    }
+
+    namespace {
+        std::atomic<std::uint64_t> nextSetId{1};
+
+        // 이 스레드가 마지막으로 쓴 (모음, 칸)
+        struct LocalSlot {
+            std::uint64_t set = 0;
+            RunCounters* counters = nullptr;
+        };
+        thread_local LocalSlot lastSlot;
+
+        std::string number(double v) {
+            if (!std::isfinite(v)) return "null";
+            std::ostringstream ss;
+            ss << std::setprecision(12) << v;
+            return ss.str();
+        }
+
+        std::string quoted(const std::string& s) {
+            std::string r = "\"";
+            for (char c : s) {
+                if (c == '"' || c == '\\') r += '\\';
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    r += buf;
+                    continue;
+                }
+                r += c;
+            }
+            return r + "\"";
+        }
+
+        // [ST] 번호와 식에 나타나는 변수 (처음 몇 개)
+        std::string constraintLabel(const HSProblem& problem, std::size_t i) {
+            std::string label = "[ST] #" + std::to_string(i + 1);
+            if (i >= problem.constraintVariables.size() || problem.constraintVariables[i].empty()) return label;
+            const auto& vars = problem.constraintVariables[i];
+            label += " (";
+            for (std::size_t k = 0; k < vars.size() && k < 4; ++k)
+                label += (k ? ", " : "") + problem.variables[static_cast<std::size_t>(vars[k])].name;
+            if (vars.size() > 4) label += ", ...";
+            return label + ")";
+        }
+
+        double seconds(std::uint64_t ns) { return static_cast<double>(ns) * 1e-9; }
+    }
+
+    CounterSet::CounterSet(std::size_t constraints) : constraints(constraints), id(nextSetId++) {}
+
+    RunCounters& CounterSet::local() {
+        if (lastSlot.set == id) return *lastSlot.counters;
+        std::lock_guard<std::mutex> lock(m);
+        const auto self = std::this_thread::get_id();
+        RunCounters* slot = nullptr;
+        for (auto& s : slots)
+            if (s.first == self) slot = &s.second;
+        if (!slot) {
+            slots.emplace_back(self, RunCounters{});
+            slot = &slots.back().second;
+            slot->enabled = true;
+            slot->rejections.assign(constraints, 0);
+        }
+        lastSlot = {id, slot};
+        return *slot;
+    }
+
+    RunCounters CounterSet::collect() const {
+        std::lock_guard<std::mutex> lock(m);
+        RunCounters total;
+        total.enabled = true;
+        total.rejections.assign(constraints, 0);
+        for (const auto& s : slots) total.merge(s.second);
+        return total;
+    }
+
+    void printRunStats(std::ostream& os, const HSResult& result, const HSProblem& problem) {
+        const RunCounters& c = result.counters;
+        const HSStats& s = result.stats;
+        std::ostringstream t;
+        t << std::fixed << std::setprecision(1);
+
+        t << "[INFO] Run statistics\n";
+        t << "  evaluations        " << s.evaluations << "\n";
+        if (!c.enabled) {
+            os << t.str() << "  (hot-path counters are off; set Stats in the parameter file or pass --stats)" << std::endl;
+            return;
+        }
+        t << "  candidates checked " << c.checked << " (" << c.feasibleRatio() * 100.0 << "% feasible)\n";
+        t << "  HM replacements    " << c.replacements;
+        if (c.improvisations) t << " (" << 100.0 * static_cast<double>(c.replacements) / static_cast<double>(c.improvisations)
+                                << "% of improvisations)";
+        t << "\n";
+        const std::uint64_t picks = c.fromMemory + c.fromPitch + c.fromRandom;
+        t << "  improvisations     " << c.improvisations;
+        if (picks) {
+            auto share = [&](std::uint64_t n) { return 100.0 * static_cast<double>(n) / static_cast<double>(picks); };
+            t << " (variables: memory " << share(c.fromMemory) << "%, pitch " << share(c.fromPitch)
+              << "%, random " << share(c.fromRandom) << "%)";
+        }
+        t << "\n";
+
+        bool anyRejection = false;
+        for (std::size_t i = 0; i < c.rejections.size(); ++i) {
+            if (!c.rejections[i]) continue;
+            if (!anyRejection) t << "  rejections by constraint\n";
+            anyRejection = true;
+            t << "    " << std::left << std::setw(40) << constraintLabel(problem, i) << std::right << " "
+              << c.rejections[i] << "\n";
+        }
+
+        const std::uint64_t timed = c.improviseNs + c.penaltyNs + c.objectiveNs + c.insertNs;
+        auto part = [&](const char* name, std::uint64_t ns) {
+            t << "    " << std::left << std::setw(12) << name << std::right << std::setprecision(3) << std::setw(10)
+              << seconds(ns) << " s" << std::setprecision(1) << std::setw(7)
+              << (timed ? 100.0 * static_cast<double>(ns) / static_cast<double>(timed) : 0.0) << "%\n";
+        };
+        t << "  time split (thread time)\n";
+        part("improvise", c.improviseNs);
+        part("penalty", c.penaltyNs);
+        part("objective", c.objectiveNs);
+        part("insert", c.insertNs);
+        t << "  wall time          " << std::setprecision(3) << result.cpu_time << " s";
+        os << t.str() << std::endl;
+    }
+
+    std::string runStatsJson(const HSResult& result, const HSProblem& problem) {
+        const RunCounters& c = result.counters;
+        const HSStats& s = result.stats;
+        std::ostringstream json;
+        json << "{\"value\": " << number(result.value)
+             << ", \"wall_seconds\": " << number(result.cpu_time)
+             << ", \"evaluations\": " << s.evaluations
+             << ", \"stop_reason\": " << quoted(stopReasonName(s.stopReason))
+             << ", \"stop_iteration\": " << s.stopIteration
+             << ", \"best_found_at\": " << s.bestFoundAt
+             << ", \"restarts\": " << s.restarts
+             << ", \"init_samples\": " << s.initSamples
+             << ", \"infeasible\": " << s.infeasible
+             << ", \"cache_lookups\": " << s.cacheLookups
+             << ", \"cache_hits\": " << s.cacheHits
+             << ", \"early_aborts\": " << s.earlyAborts
+             << ", \"duplicates_skipped\": " << s.duplicatesSkipped
+             << ", \"surrogate_skipped\": " << s.surrogateSkipped
+             << ", \"repair_attempts\": " << s.repairAttempts
+             << ", \"repair_successes\": " << s.repairSuccesses;
+        if (c.enabled) {
+            json << ", \"counters\": {\"improvisations\": " << c.improvisations
+                 << ", \"from_memory\": " << c.fromMemory
+                 << ", \"from_pitch\": " << c.fromPitch
+                 << ", \"from_random\": " << c.fromRandom
+                 << ", \"replacements\": " << c.replacements
+                 << ", \"checked\": " << c.checked
+                 << ", \"feasible\": " << c.feasible
+                 << ", \"feasible_ratio\": " << number(c.feasibleRatio())
+                 << ", \"rejections\": [";
+            for (std::size_t i = 0; i < c.rejections.size(); ++i)
+                json << (i ? ", " : "") << "{\"constraint\": " << i + 1 << ", \"label\": "
+                     << quoted(constraintLabel(problem, i)) << ", \"count\": " << c.rejections[i] << "}";
+            json << "], \"seconds\": {\"improvise\": " << number(seconds(c.improviseNs))
+                 << ", \"penalty\": " << number(seconds(c.penaltyNs))
+                 << ", \"objective\": " << number(seconds(c.objectiveNs))
+                 << ", \"insert\": " << number(seconds(c.insertNs)) << "}}";
+        }
+        json << "}";
+        return json.str();
+    }
+}
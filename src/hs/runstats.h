@@ -0,0 +1,85 @@
+#ifndef HSL_RUNSTATS_
+#define HSL_RUNSTATS_
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+namespace hsl {
+
+    struct HSResult;
+    struct HSProblem;
+
+    // 실행 중 핫 경로 계수기 (Stats). 스레드마다 따로 세고 실행이 끝나면 merge로 합친다
+    struct RunCounters {
+        bool enabled = false;             // Stats로 센 값인지 (꺼져 있으면 모두 0)
+        std::uint64_t improvisations = 0; // 즉흥 연주한 후보 수
+        std::uint64_t fromMemory = 0;     // 변수 단위: HM 값 그대로
+        std::uint64_t fromPitch = 0;      //            HM 값을 음정 조정 (GHS/SGHS의 최적 해 성분 포함)
+        std::uint64_t fromRandom = 0;     //            범위에서 새로 뽑음
+        std::uint64_t replacements = 0;   // HM worst를 바꾼 수
+        std::uint64_t checked = 0;        // 제약을 판정한 후보 수 (초기 표본 포함, 캐시 적중 제외)
+        std::uint64_t feasible = 0;       // 그중 실행 가능한 수
+        std::vector<std::uint64_t> rejections; // [ST]별: 이 제약을 어겨 위반 후보가 된 수
+        // 구간별 누적 시간 (ns). 병렬 구간은 스레드 시간의 합이라 실행 시간보다 클 수 있다
+        std::uint64_t improviseNs = 0;    // 즉흥 연주 (난수)
+        std::uint64_t penaltyNs = 0;      // 제약 위반 계산과 보정
+        std::uint64_t objectiveNs = 0;
+        std::uint64_t insertNs = 0;       // HM 교체
+
+        void merge(const RunCounters& other);
+        [[nodiscard]] double feasibleRatio() const {
+            return checked ? static_cast<double>(feasible) / static_cast<double>(checked) : 0.0;
+        }
+    };
+
+    // 스레드별 RunCounters 모음. local()은 처음 부를 때만 잠그고 이후에는 thread_local 캐시로 바로 돌려준다
+    class CounterSet {
+    public:
+        explicit CounterSet(std::size_t constraints);
+        CounterSet(const CounterSet&) = delete;
+        CounterSet& operator=(const CounterSet&) = delete;
+
+        RunCounters& local();
+        // 모든 스레드의 합. 다른 스레드가 세는 중이 아닐 때 부른다
+        [[nodiscard]] RunCounters collect() const;
+
+    private:
+        std::size_t constraints;
+        std::uint64_t id;                 // thread_local 캐시 구분용 (재사용하지 않음)
+        mutable std::mutex m;
+        std::deque<std::pair<std::thread::id, RunCounters>> slots; // deque: 참조가 유지됨
+    };
+
+    // sink가 있으면 수명 동안의 시간을 ns로 더한다 (없으면 시계를 읽지 않음)
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(std::uint64_t* sink) : sink(sink) {
+            if (sink) begin = std::chrono::steady_clock::now();
+        }
+        ~ScopedTimer() {
+            if (sink)
+                *sink += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - begin).count());
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        std::uint64_t* sink;
+        std::chrono::steady_clock::time_point begin;
+    };
+
+    // --stats 표 (사람용)
+    void printRunStats(std::ostream& os, const HSResult& result, const HSProblem& problem);
+    // 대시보드용 JSON 객체 하나 (한 줄)
+    std::string runStatsJson(const HSResult& result, const HSProblem& problem);
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include "solver.h"
+#include "io.h"
+#include "../utils/threadpool.h"
+
+namespace hsl {
+
+    StepSolver::StepSolver(const HSProblem& prob, const HSParams& params, unsigned int seed, const char* name)
+            : problem(prob), params(params), out(params.Quiet ? silent : hsl::cout), rng{seed}, seed(seed),
+              start(std::chrono::steady_clock::now()), label(name) {
+        bestSoFar.value = invalidValue();
+        if (params.Stats) counterSet = std::make_unique<CounterSet>(problem.constraintVariables.size());
+    }
+
+    RunCounters StepSolver::counters() const {
+        return counterSet ? counterSet->collect() : RunCounters{};
+    }
+
+    double StepSolver::invalidValue() const {
+        return problem.maximize ? std::numeric_limits<double>::lowest() : std::numeric_limits<double>::infinity();
+    }
+
+    bool StepSolver::better(const Harmony& a, const Harmony& b) const {
+        if (a.violation == 0.0 && b.violation == 0.0) return problem.maximize ? a.value > b.value : a.value < b.value;
+        return a.violation < b.violation;
+    }
+
+    void StepSolver::clampToBounds(std::vector<double>& x) const {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            const auto& var = problem.variables[i];
+            double v = std::clamp(x[i], var.range.first, var.range.second);
+            x[i] = var.isInt ? std::round(v) : v;
+        }
+    }
+
+    std::vector<double> StepSolver::randomPoint() {
+        std::vector<double> x(problem.variables.size());
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            const auto& var = problem.variables[i];
+            if (var.isInt) {
+                double lo = std::ceil(var.range.first), hi = std::floor(var.range.second);
+                x[i] = std::min(hi, lo + std::floor(rng.uniform() * (hi - lo + 1.0)));
+            } else {
+                x[i] = var.range.first + rng.uniform() * (var.range.second - var.range.first);
+            }
+        }
+        return x;
+    }
+
+    void StepSolver::evaluateAll(std::vector<Harmony>& pop, std::size_t from) {
+        const std::size_t count = pop.size() - from;
+        std::vector<std::uint64_t> streams(count);
+        for (std::size_t k = 0; k < count; ++k) streams[k] = deriveStream(seed, evalCount++);
+
+        auto check = [&](std::size_t k) {
+            Harmony& h = pop[from + k];
+            clampToBounds(h.vars);
+            if (problem.repair) problem.repair(h.vars);
+            RunCounters* counters = counterSet ? &counterSet->local() : nullptr;
+            {
+                ScopedTimer timer(counters ? &counters->penaltyNs : nullptr);
+                if (problem.violationSeeded) {
+                    h.violation = problem.violationSeeded(h.vars, deriveStream(streams[k], 1));
+                } else {
+                    double pen = problem.penaltySeeded ? problem.penaltySeeded(h.vars, deriveStream(streams[k], 1))
+                                                       : problem.penalty(h.vars);
+                    h.violation = pen == 0.0 ? 0.0 : 1.0;
+                }
+            }
+            h.value = invalidValue();
+            if (h.violation == 0.0 && !problem.objectiveBatch) {
+                ScopedTimer timer(counters ? &counters->objectiveNs : nullptr);
+                h.value = problem.objectiveSeeded ? problem.objectiveSeeded(h.vars, deriveStream(streams[k], 0))
+                                                  : problem.objective(h.vars);
+            }
+        };
+        if (problem.parallelSafe) ThreadPool::shared().parallelFor(count, check);
+        else for (std::size_t k = 0; k < count; ++k) check(k);
+
+        if (problem.objectiveBatch) {
+            std::vector<std::vector<double>> points;
+            std::vector<std::uint64_t> objStreams;
+            std::vector<std::size_t> picked;
+            for (std::size_t k = 0; k < count; ++k) {
+                if (pop[from + k].violation != 0.0) continue;
+                points.push_back(pop[from + k].vars);
+                objStreams.push_back(deriveStream(streams[k], 0));
+                picked.push_back(from + k);
+            }
+            std::vector<double> values;
+            if (!points.empty()) {
+                ScopedTimer timer(counterSet ? &counterSet->local().objectiveNs : nullptr);
+                problem.objectiveBatch(points, objStreams, values);
+            }
+            for (std::size_t j = 0; j < picked.size(); ++j) pop[picked[j]].value = values[j];
+        }
+
+        const std::uint64_t first = evalCount - count + 1;
+        std::vector<double> perConstraint;
+        for (std::size_t k = 0; k < count; ++k) {
+            Harmony& h = pop[from + k];
+            if (counterSet) {
+                RunCounters& counters = counterSet->local();
+                ++counters.checked;
+                if (h.violation == 0.0) {
+                    ++counters.feasible;
+                } else if (problem.constraintViolations) {
+                    ScopedTimer timer(&counters.penaltyNs);
+                    problem.constraintViolations(h.vars, deriveStream(streams[k], 1), perConstraint);
+                    for (std::size_t i = 0; i < perConstraint.size() && i < counters.rejections.size(); ++i)
+                        if (perConstraint[i] > 0.0) ++counters.rejections[i];
+                }
+            }
+            if (h.violation > 0.0) {
+                ++statistics.infeasible;
+            } else {
+                ++statistics.evaluations;
+                if (!statistics.firstFeasibleAt) statistics.firstFeasibleAt = first + k;
+                if (std::isnan(h.value)) h.value = invalidValue(); // 평가 실패
+            }
+            if (better(h, bestSoFar)) {
+                bestSoFar = h;
+                statistics.bestFoundAt = statistics.evaluations;
+            }
+        }
+    }
+
+    void StepSolver::inject(const Harmony& h) {
+        if (better(h, bestSoFar)) bestSoFar = h;
+    }
+
+    bool StepSolver::stopped() {
+        if (!std::isnan(params.Target) && bestSoFar.violation == 0.0 &&
+            (problem.maximize ? bestSoFar.value >= params.Target : bestSoFar.value <= params.Target)) {
+            statistics.stopReason = StopReason::Target;
+            return true;
+        }
+        if (params.TimeLimit > 0.0 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= params.TimeLimit) {
+            statistics.stopReason = StopReason::TimeLimit;
+            return true;
+        }
+        return false;
+    }
+
+    bool StepSolver::advance(std::uint64_t budget) {
+        const std::uint64_t goal = evalCount + budget;
+        if (!initialized) {
+            initialize();
+            initialized = true;
+            statistics.initSamples = evalCount;
+        }
+        while (evalCount < goal) {
+            if (stopped()) return false;
+            step();
+        }
+        return !stopped();
+    }
+
+    Harmony StepSolver::optimize() {
+        const int barWidth = 50;
+        out << "[INFO] Optimization started... (" << label << ")" << std::endl;
+        const std::uint64_t chunk = std::max<std::uint64_t>(1, params.MaxImp / 50);
+        while (evalCount < params.MaxImp) {
+            bool more = advance(std::min<std::uint64_t>(chunk, params.MaxImp - evalCount));
+            float progress = std::min(1.0f, static_cast<float>(evalCount) / static_cast<float>(params.MaxImp));
+            int pos = static_cast<int>(barWidth * progress);
+            out << "\r[";
+            for (int i = 0; i < barWidth; ++i) out << (i < pos ? "#" : "-");
+            out << "] " << std::setw(3) << int(progress * 100.0f) << "%   " << std::flush;
+            if (!more) break;
+        }
+        out << std::endl;
+
+        statistics.stopIteration = static_cast<unsigned int>(std::min<std::uint64_t>(evalCount, params.MaxImp));
+        if (statistics.stopReason != StopReason::MaxImp) {
+            out << "[INFO] Stopped early (" << stopReasonName(statistics.stopReason)
+                << ") at candidate " << evalCount << std::endl;
+        }
+        out << "[INFO] " << label << ": best found after " << statistics.bestFoundAt << " evaluations" << std::endl;
+        if (statistics.infeasible > 0) {
+            out << "[INFO] " << statistics.infeasible << " infeasible candidates, ";
+            if (statistics.firstFeasibleAt) out << "first feasible at candidate " << statistics.firstFeasibleAt;
+            else out << "no feasible candidate";
+            out << std::endl;
+        }
+        if (bestSoFar.violation > 0.0)
+            out << "[WARN] No feasible solution found; the best one violates the constraints by "
+                << bestSoFar.violation << std::endl;
+        return bestSoFar;
+    }
+
+}
@@ -0,0 +1,69 @@
+#ifndef HSL_SOLVER_
+#define HSL_SOLVER_
+
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include "hsalgorithm.h"
+#include "params.h"
+#include "../utils/random.h"
+#include "../interpreter/evaluator.h"
+
+namespace hsl {
+
+    // 세대 단위로 진행하는 엔진(DE, PSO, CMA-ES, 패턴 탐색)의 공통 부분.
+    // 예산은 후보 수(MaxImp)로 세고, 해의 비교는 Deb 규칙(실행 가능 해 > 위반 해, 위반끼리는 위반 정도)을 따른다.
+    // 후보 번호로 난수 스트림을 정하고 평가는 스레드 풀에서 병렬로 하므로 스레드 수와 무관하게 결정적이다
+    class StepSolver : public Solver {
+    public:
+        StepSolver(const HSProblem& prob, const HSParams& params, unsigned int seed, const char* name);
+        Harmony optimize() override;
+        [[nodiscard]] const HSStats& stats() const override { return statistics; }
+        [[nodiscard]] RunCounters counters() const override;
+
+        // 처음이면 초기화하고, 후보 수가 budget만큼 늘 때까지 세대를 진행한다 (마지막 세대는 넘칠 수 있음).
+        // Target/TimeLimit에 걸리면 false
+        virtual bool advance(std::uint64_t budget);
+        // 다른 엔진이 찾은 해를 받아들인다 (포트폴리오의 최적 해 공유)
+        virtual void inject(const Harmony& h);
+        [[nodiscard]] const Harmony& incumbent() const { return bestSoFar; }
+        [[nodiscard]] std::uint64_t candidates() const { return evalCount; }
+        [[nodiscard]] const char* name() const { return label; }
+        // a가 b보다 나은 해인가 (Deb 규칙)
+        [[nodiscard]] bool better(const Harmony& a, const Harmony& b) const;
+
+    protected:
+        const HSProblem& problem;
+        HSParams params;
+        std::ostream silent{nullptr};
+        std::ostream& out;
+        SplitMix64 rng;
+        std::uint64_t seed;
+        std::uint64_t evalCount = 0;     // 후보 번호 (예산)
+        HSStats statistics;
+        Harmony bestSoFar{{}, 0.0, std::numeric_limits<double>::infinity()};
+        std::chrono::steady_clock::time_point start;
+        bool initialized = false;
+        const char* label;
+        std::unique_ptr<CounterSet> counterSet; // Stats: 평가 단계의 계수기 (즉흥 연주/HM 교체 항목은 HS 전용)
+
+        virtual void initialize() = 0;
+        virtual void step() = 0;
+
+        // 범위로 자르고 int 변수는 반올림
+        void clampToBounds(std::vector<double>& x) const;
+        [[nodiscard]] std::vector<double> randomPoint();
+        // pop[from..]을 평가해 value/violation을 채우고 최적 해를 갱신한다
+        void evaluateAll(std::vector<Harmony>& pop, std::size_t from = 0);
+        [[nodiscard]] double invalidValue() const;
+
+    private:
+        bool stopped();
+    };
+
+}
+
+#endif
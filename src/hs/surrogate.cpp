@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include "surrogate.h"
+
+namespace hsl {
+
+    Surrogate::Surrogate(const std::vector<Variable>& variables, std::size_t capacity)
+            : n(variables.size()), capacity(capacity), worker([this] { run(); }) {
+        for (const auto& v : variables) {
+            lower.push_back(v.range.first);
+            span.push_back(v.range.second > v.range.first ? v.range.second - v.range.first : 1.0);
+        }
+        refit = std::max<std::size_t>(5, capacity / 10);
+        scratch.resize(n);
+    }
+
+    Surrogate::~Surrogate() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    void Surrogate::add(const std::vector<double>& x, double y) {
+        if (!std::isfinite(y) || unusable()) return;
+        std::vector<double> z(n);
+        for (std::size_t i = 0; i < n; ++i) z[i] = (x[i] - lower[i]) / span[i];
+        for (const auto& p : xs)
+            if (p == z) return; // 같은 점이 두 번 있으면 보간 행렬이 특이해진다
+
+        xs.push_back(std::move(z));
+        ys.push_back(y);
+        if (ys.size() > capacity) {
+            xs.pop_front();
+            ys.pop_front();
+        }
+        // 첫 맞춤은 점이 모이는 즉시, 이후(실패한 뒤 포함)는 refit개마다
+        ++sinceFit;
+        if (ys.size() >= minPoints() && (!attempted || sinceFit >= refit)) launch();
+    }
+
+    // 끝난 맞춤 결과를 받아들인다 (m을 잡은 채로 부름). 실패하면 지금 모델을 유지하고 연속 실패 수를 센다
+    void Surrogate::accept() {
+        if (!finished) return;
+        finished = false;
+        if (fitted) {
+            current = std::move(fitted);
+            failures = 0;
+        } else {
+            ++failures;
+        }
+        fitted.reset();
+    }
+
+    // 지난 맞춤 결과를 받아들이고 지금 보관소로 새 맞춤을 시작한다. 아직 모델이 없으면 이번 맞춤을 기다린다
+    void Surrogate::launch() {
+        sinceFit = 0;
+        attempted = true;
+        std::unique_lock<std::mutex> lk(m);
+        cv.wait(lk, [this] { return !busy; });
+        accept();
+        if (failed()) return;
+
+        jobX.clear();
+        for (const auto& p : xs) jobX.insert(jobX.end(), p.begin(), p.end());
+        jobY.assign(ys.begin(), ys.end());
+        queued = busy = true;
+        cv.notify_all();
+
+        if (!current) {
+            cv.wait(lk, [this] { return !busy; });
+            accept();
+        }
+    }
+
+    void Surrogate::run() {
+        std::vector<double> x, y;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk, [this] { return queued || stopping; });
+                if (stopping) return;
+                queued = false;
+                std::swap(x, jobX);
+                std::swap(y, jobY);
+            }
+            auto model = fit(x, y, n);
+            {
+                std::lock_guard<std::mutex> lk(m);
+                fitted = std::move(model);
+                finished = true;
+                busy = false;
+            }
+            cv.notify_all();
+        }
+    }
+
+    // [Φ+μI P; Pᵀ 0][λ; c] = [y; 0] 을 부분 피벗 가우스 소거로 푼다. 특이하면 nullptr.
+    // 점들이 1차 관계를 만족하면(등식 제약의 닫힌 해, 고정된 변수) P의 열이 종속되어 행렬이 특이해지므로
+    // 앞 열들로 표현되는 꼬리 열은 빼고(계수 0) 맞춘다. μ는 거의 겹치는 점에 대비한 작은 릿지
+    std::shared_ptr<const Surrogate::Model> Surrogate::fit(const std::vector<double>& x, const std::vector<double>& y,
+                                                           std::size_t n) {
+        const std::size_t m = y.size();
+        auto model = std::make_shared<Model>();
+
+        // 꼬리 열 (0: 상수, 1+k: 변수 k) 중 독립인 것만 고른다 (재직교화한 그람-슈미트)
+        std::vector<std::size_t> tail;
+        {
+            std::vector<std::vector<double>> basis;
+            std::vector<double> col(m);
+            for (std::size_t t = 0; t <= n; ++t) {
+                for (std::size_t i = 0; i < m; ++i) col[i] = t == 0 ? 1.0 : x[i * n + t - 1];
+                double before = 0.0;
+                for (double v : col) before += v * v;
+                for (int pass = 0; pass < 2; ++pass)
+                    for (const auto& q : basis) {
+                        double d = 0.0;
+                        for (std::size_t i = 0; i < m; ++i) d += q[i] * col[i];
+                        for (std::size_t i = 0; i < m; ++i) col[i] -= d * q[i];
+                    }
+                double after = 0.0;
+                for (double v : col) after += v * v;
+                if (before == 0.0 || after <= 1e-18 * before) continue;
+                const double norm = std::sqrt(after);
+                for (double& v : col) v /= norm;
+                basis.push_back(col);
+                tail.push_back(t);
+            }
+        }
+        const std::size_t T = tail.size();
+        const std::size_t N = m + T;
+
+        double mean = 0.0, sq = 0.0;
+        for (double v : y) mean += v;
+        mean /= static_cast<double>(m);
+        for (double v : y) sq += (v - mean) * (v - mean);
+        model->mean = mean;
+        model->scale = sq > 0.0 ? std::sqrt(sq / static_cast<double>(m)) : 1.0;
+
+        std::vector<double> A(N * N, 0.0), b(N, 0.0);
+        for (std::size_t i = 0; i < m; ++i) {
+            const double* xi = &x[i * n];
+            for (std::size_t j = i + 1; j < m; ++j) {
+                const double* xj = &x[j * n];
+                double d2 = 0.0;
+                for (std::size_t k = 0; k < n; ++k) d2 += (xi[k] - xj[k]) * (xi[k] - xj[k]);
+                double r = std::sqrt(d2);
+                A[i * N + j] = A[j * N + i] = r * r * r;
+            }
+            for (std::size_t k = 0; k < T; ++k)
+                A[i * N + m + k] = A[(m + k) * N + i] = tail[k] == 0 ? 1.0 : xi[tail[k] - 1];
+            b[i] = (y[i] - mean) / model->scale;
+        }
+
+        double largest = 0.0;
+        for (double v : A) largest = std::max(largest, std::fabs(v));
+        for (std::size_t i = 0; i < m; ++i) A[i * N + i] += 1e-10 * largest;
+        for (std::size_t c = 0; c < N; ++c) {
+            std::size_t p = c;
+            for (std::size_t r = c + 1; r < N; ++r)
+                if (std::fabs(A[r * N + c]) > std::fabs(A[p * N + c])) p = r;
+            if (std::fabs(A[p * N + c]) <= 1e-12 * largest) return nullptr;
+            if (p != c) {
+                for (std::size_t k = c; k < N; ++k) std::swap(A[c * N + k], A[p * N + k]);
+                std::swap(b[c], b[p]);
+            }
+            for (std::size_t r = c + 1; r < N; ++r) {
+                double f = A[r * N + c] / A[c * N + c];
+                if (f == 0.0) continue;
+                for (std::size_t k = c; k < N; ++k) A[r * N + k] -= f * A[c * N + k];
+                b[r] -= f * b[c];
+            }
+        }
+        for (std::size_t c = N; c-- > 0;) {
+            double s = b[c];
+            for (std::size_t k = c + 1; k < N; ++k) s -= A[c * N + k] * b[k];
+            b[c] = s / A[c * N + c];
+        }
+
+        // 계수 배치는 predict 기준 (RBF m개, 변수별 n개, 상수항). 뺀 꼬리 열은 0
+        model->weights.assign(m + n + 1, 0.0);
+        std::copy(b.begin(), b.begin() + static_cast<std::ptrdiff_t>(m), model->weights.begin());
+        for (std::size_t k = 0; k < T; ++k) model->weights[tail[k] == 0 ? m + n : m + tail[k] - 1] = b[m + k];
+        model->centers = x;
+        return model;
+    }
+
+    bool Surrogate::predict(const std::vector<double>& x, double& y) const {
+        if (!current) return false;
+        const Model& mdl = *current;
+        const std::size_t m = mdl.centers.size() / std::max<std::size_t>(n, 1);
+        for (std::size_t i = 0; i < n; ++i) scratch[i] = (x[i] - lower[i]) / span[i];
+
+        double s = mdl.weights[m + n]; // 상수항
+        for (std::size_t k = 0; k < n; ++k) s += mdl.weights[m + k] * scratch[k];
+        for (std::size_t j = 0; j < m; ++j) {
+            const double* c = &mdl.centers[j * n];
+            double d2 = 0.0;
+            for (std::size_t k = 0; k < n; ++k) d2 += (scratch[k] - c[k]) * (scratch[k] - c[k]);
+            double r = std::sqrt(d2);
+            s += mdl.weights[j] * r * r * r;
+        }
+        y = mdl.mean + mdl.scale * s;
+        return true;
+    }
+
+}
@@ -0,0 +1,78 @@
+#ifndef HSL_SURROGATE_
+#define HSL_SURROGATE_
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include "../interpreter/evaluator.h"
+#include "../utils/jthread.h"
+
+namespace hsl {
+
+    // 평가한 해의 보관소(최근 capacity개)에 맞춘 RBF 대리 모델. 삼차 커널 r^3 + 1차 다항식 꼬리이고,
+    // 변수는 범위로 [0,1]에, 목적 값은 평균/표준편차로 정규화해서 맞춘다.
+    // 보관소가 refit개 늘 때마다 백그라운드 스레드에서 다시 맞추고, 그 결과는 다음 맞춤을 시작할 때(필요하면 기다려서) 받아들인다.
+    // 예측에 쓰는 모델 세대가 보관소 크기로만 정해지므로 스레드 속도와 무관하게 결정적이다
+    class Surrogate {
+    public:
+        Surrogate(const std::vector<Variable>& variables, std::size_t capacity);
+        ~Surrogate();
+        Surrogate(const Surrogate&) = delete;
+        Surrogate& operator=(const Surrogate&) = delete;
+
+        // 실제 목적 값 하나 추가 (유한하지 않은 값, 이미 있는 점은 무시)
+        void add(const std::vector<double>& x, double y);
+        // 맞춘 모델이 아직 없으면 false
+        bool predict(const std::vector<double>& x, double& y) const;
+        [[nodiscard]] std::size_t size() const { return ys.size(); }
+        // 변수 수에 비해 보관소가 작아 맞출 수 없는지 (1차 꼬리에 n+2개 이상 필요)
+        [[nodiscard]] bool unusable() const { return capacity < minPoints(); }
+        // 맞춤이 연달아 실패해 더는 시도하지 않는지 (호출한 쪽에서 끄고 알린다)
+        [[nodiscard]] bool failed() const { return failures >= maxFailures; }
+
+    private:
+        struct Model {
+            std::vector<double> centers; // m * n (정규화된 좌표)
+            std::vector<double> weights; // m개 RBF 계수, 이어서 n+1개 다항식 계수
+            double mean = 0.0, scale = 1.0;
+        };
+
+        std::size_t n;
+        std::vector<double> lower, span;
+        std::size_t capacity;
+        std::size_t refit;               // 이만큼 새 점이 모이면 다시 맞춤
+        std::size_t sinceFit = 0;
+        bool attempted = false;          // 첫 맞춤을 시작했는지
+        std::size_t failures = 0;        // 연속으로 실패한 맞춤 수
+        static constexpr std::size_t maxFailures = 3;
+        std::deque<std::vector<double>> xs; // 정규화된 좌표
+        std::deque<double> ys;
+        std::shared_ptr<const Model> current; // 예측에 쓰는 세대 (호출 스레드만 접근)
+        mutable std::vector<double> scratch;
+
+        // 백그라운드 맞춤
+        std::mutex m;
+        std::condition_variable cv;
+        std::vector<double> jobX, jobY;
+        std::shared_ptr<const Model> fitted;  // 끝난 맞춤 (실패하면 nullptr)
+        bool finished = false;                // 받아들이지 않은 맞춤 결과가 있음
+        bool queued = false;
+        bool busy = false;
+        bool stopping = false;
+        jthread worker;                       // 마지막에 선언 (다른 멤버가 준비된 뒤 시작)
+
+        [[nodiscard]] std::size_t minPoints() const { return std::max<std::size_t>(n + 2, 10); }
+        void launch();
+        void accept();
+        void run();
+        static std::shared_ptr<const Model> fit(const std::vector<double>& x, const std::vector<double>& y,
+                                                std::size_t n);
+    };
+
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "trace.h"
+
+namespace hsl {
+
+    namespace {
+        constexpr char traceMagic[8] = {'H', 'S', 'L', 'T', 'R', 'C', '0', '1'};
+        constexpr auto drainPause = std::chrono::milliseconds(10); // 버퍼가 비었을 때 기록 스레드가 쉬는 시간
+
+        std::size_t roundUpPow2(std::size_t n) {
+            std::size_t p = 1;
+            while (p < n) p <<= 1;
+            return p;
+        }
+    }
+
+    bool TraceWriter::binaryPath(const std::string& path) {
+        return path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0;
+    }
+
+    TraceWriter::TraceWriter(const std::string& path, std::size_t capacity)
+            : file(path, std::ios::binary | std::ios::trunc), binary(binaryPath(path)),
+              ring(roundUpPow2(std::max<std::size_t>(capacity, 2))), mask(ring.size() - 1) {
+        // 파일 상태를 확인한 뒤에 기록 스레드를 시작한다 (헤더는 그 스레드가 처음에 씀)
+        if (!file) throw std::runtime_error("Cannot open trace file: " + path);
+        worker = jthread([this] { run(); });
+    }
+
+    TraceWriter::~TraceWriter() {
+        close();
+    }
+
+    void TraceWriter::close() {
+        stopping.store(true, std::memory_order_release);
+        if (worker.joinable()) worker.join(); // 남은 점은 run이 기록하고 끝낸다
+    }
+
+    void TraceWriter::push(const TracePoint& p) {
+        if (stopping.load(std::memory_order_relaxed)) return;
+        const std::uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) > mask) {
+            ++waits;
+            do std::this_thread::yield();
+            while (h - tail.load(std::memory_order_acquire) > mask);
+        }
+        ring[h & mask] = p;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    std::string TraceWriter::takeError() {
+        std::lock_guard<std::mutex> lk(m);
+        return std::exchange(error, std::string{});
+    }
+
+    void TraceWriter::write(const TracePoint* points, std::size_t count) {
+        if (binary) {
+            // TracePoint는 채움 바이트 없는 8바이트 필드 7개이므로 그대로 쓴다
+            file.write(reinterpret_cast<const char*>(points), static_cast<std::streamsize>(count * sizeof(TracePoint)));
+            return;
+        }
+        // to_chars: 다시 읽으면 같은 값이 되는 가장 짧은 표현 (printf보다 훨씬 빠름)
+        char line[256];
+        for (std::size_t k = 0; k < count; ++k) {
+            const TracePoint& p = points[k];
+            char* at = line;
+            char* end = line + sizeof(line);
+            auto field = [&](auto v, char sep) {
+                at = std::to_chars(at, end - 1, v).ptr;
+                *at++ = sep;
+            };
+            field(p.iteration, ',');
+            field(p.evaluations, ',');
+            field(p.elapsed, ',');
+            field(p.best, ',');
+            field(p.worst, ',');
+            field(p.mean, ',');
+            field(p.diversity, '\n');
+            file.write(line, at - line);
+        }
+    }
+
+    void TraceWriter::run() {
+        if (!file) return;
+        if (binary) {
+            file.write(traceMagic, sizeof(traceMagic));
+            const auto size = static_cast<std::uint32_t>(sizeof(TracePoint));
+            file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        } else {
+            file << "iteration,evaluations,elapsed,best,worst,mean,diversity\n";
+        }
+
+        for (;;) {
+            const bool last = stopping.load(std::memory_order_acquire);
+            std::uint64_t t = tail.load(std::memory_order_relaxed);
+            const std::uint64_t h = head.load(std::memory_order_acquire);
+            while (t != h) {
+                // 링 끝에서 끊어 연속 구간씩 (최대 256개: 가득 찬 버퍼를 기다리는 생산자에게 자리를 빨리 돌려준다)
+                const std::size_t from = static_cast<std::size_t>(t & mask);
+                const std::size_t count = static_cast<std::size_t>(
+                        std::min<std::uint64_t>({h - t, ring.size() - from, 256}));
+                write(ring.data() + from, count);
+                t += count;
+                tail.store(t, std::memory_order_release);
+            }
+            if (last) break; // stopping을 본 뒤 한 번 더 비웠으므로 남은 점이 없다
+            file.flush();
+            std::this_thread::sleep_for(drainPause);
+        }
+
+        file.flush();
+        if (!file) {
+            std::lock_guard<std::mutex> lk(m);
+            error = "write failed";
+        }
+    }
+
+}
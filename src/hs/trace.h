@@ -0,0 +1,70 @@
+#ifndef HSL_TRACE_
+#define HSL_TRACE_
+// 수렴 기록 (Trace). 최적화 루프가 점을 링 버퍼에 넣으면 전용 스레드가 꺼내 CSV 또는 이진 파일로 쓴다.
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../utils/jthread.h"
+
+namespace hsl {
+
+    // 이진 파일에 그대로 쓰므로 8바이트 필드만 둔다
+    struct TracePoint {
+        std::uint64_t iteration = 0;
+        std::uint64_t evaluations = 0;
+        double elapsed = 0.0;    // 초
+        double best = 0.0;       // 지금까지의 최적 해
+        double worst = 0.0;      // HM worst
+        double mean = 0.0;       // HM 목적 값 평균 (유한한 값만, 없으면 NaN)
+        double diversity = 0.0;  // 변수별 HM 표준편차 / 범위 의 평균
+    };
+    static_assert(sizeof(TracePoint) == 56, "TracePoint is written as raw bytes");
+
+    // 단일 생산자/단일 소비자 링 버퍼와 기록 스레드. push는 잠그지 않고 시스템 호출도 하지 않는다.
+    // 파일 형식은 경로로 정한다: ".bin"으로 끝나면 이진, 아니면 CSV (머리글 한 줄).
+    // 이진 형식: "HSLTRC01" (8바이트) + u32 점 하나의 바이트 수(56), 이어서 TracePoint 순서대로
+    // u64 iteration, u64 evaluations, f64 elapsed, best, worst, mean, diversity (기록한 기계의 바이트 순서)
+    class TraceWriter {
+    public:
+        // 파일을 열 수 없으면 예외
+        explicit TraceWriter(const std::string& path, std::size_t capacity = std::size_t{1} << 14);
+        ~TraceWriter(); // 남은 점을 기록하고 종료
+
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+
+        // 버퍼가 가득 차 있으면 기록 스레드가 자리를 낼 때까지 양보하며 기다린다 (stalls에 기록)
+        void push(const TracePoint& p);
+        // 남은 점을 기록하고 스레드를 끝낸다. 이후 push는 무시된다
+        void close();
+        // 기록 실패 메시지 (없으면 빈 문자열). close 뒤에 부른다
+        [[nodiscard]] std::string takeError();
+        [[nodiscard]] std::uint64_t written() const { return tail.load(std::memory_order_acquire); }
+        [[nodiscard]] std::uint64_t stalls() const { return waits; }
+        [[nodiscard]] static bool binaryPath(const std::string& path);
+
+    private:
+        std::ofstream file;
+        bool binary;
+        std::vector<TracePoint> ring;     // 크기는 2의 거듭제곱
+        std::size_t mask;
+        alignas(64) std::atomic<std::uint64_t> head{0}; // 다음에 쓸 자리 (생산자만 증가)
+        alignas(64) std::atomic<std::uint64_t> tail{0}; // 다음에 읽을 자리 (소비자만 증가)
+        std::atomic<bool> stopping{false};
+        std::uint64_t waits = 0;          // 생산자 전용
+        std::mutex m;
+        std::string error;
+        jthread worker;                   // 생성자 본문에서 파일을 확인한 뒤 시작
+
+        void run();
+        void write(const TracePoint* points, std::size_t count);
+    };
+
+}
+
+#endif
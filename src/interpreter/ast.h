@@ -14,7 +14,8 @@ namespace hsl{
 
     struct Objective {
         bool isMax; // true = max, false = min
-        struct Expression* expr;
+        struct Expression* expr;  // external이면 nullptr
+        std::string external;     // [OBJ] min external "명령": 목적 값을 외부 프로세스가 계산
     }; //목적함수.
 
     struct VarDecl {
@@ -22,16 +23,19 @@ namespace hsl{
         Expression* lower;
         Expression* upper;
         bool isInt; // true=int, false=any(double)
+        Expression* bandwidth = nullptr; // 음정 조정 대역폭 (선택, ", bw = 식")
     }; //변수 정의.
 
     struct Constraint {
         struct Expression* left;
         TokenType comparator;         // LEQ, GEQ, EQ, NEQ, LT, GT
         struct Expression* right;
+        int line = 0, column = 0;     // [ST] 토큰 위치
     }; //제약조건 정의.
 
     struct Expression {
         virtual ~Expression() = default;
+        int line = 0, column = 0; // 소스 위치 (이항 연산은 연산자, 함수 호출은 이름의 위치). 프로파일 보고용
     };
 
     struct NumberExpr : Expression {
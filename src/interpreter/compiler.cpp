@@ -0,0 +1,865 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "compiler.h"
+#include "profiler.h"
+#include "../utils/threadpool.h"
+
+namespace hsl {
+
+    double CompiledModel::eval(int idx, EvalContext& ctx) const {
+        const Node& n = nodes[idx];
+        switch (n.op) {
+            case OpCode::CONST: return n.value;
+            case OpCode::VAR:   return ctx.vars[n.slot];
+            case OpCode::LOCAL: return ctx.locals[n.slot];
+            case OpCode::INDEX: {
+                const IndexTable& t = indexTables[n.slot];
+                int i = static_cast<int>(eval(n.a, ctx));
+                long k = static_cast<long>(i) - t.first;
+                if (k < 0 || k >= static_cast<long>(t.slots.size()) || t.slots[k] < 0) {
+                    std::string key = t.name + "[" + std::to_string(i) + "]";
+                    throw std::runtime_error(
+                            "Undefined variable access: '" + key +
+                            "'.\nMake sure it is declared in [VAR] section (e.g., [VAR] "
+                            + key + ", ... )");
+                } // 만약 range와 관련된 변수들이 제대로 정의가 되지 않았다면(ex: sum(i, 1, 3, x[i])에서 x[1], x[2]만 정의한 경우, 이 경우는 error.
+                return ctx.vars[t.slots[k]];
+            }
+            case OpCode::NEG: return -eval(n.a, ctx);
+            case OpCode::ADD: return eval(n.a, ctx) + eval(n.b, ctx);
+            case OpCode::SUB: return eval(n.a, ctx) - eval(n.b, ctx);
+            case OpCode::MUL: return eval(n.a, ctx) * eval(n.b, ctx);
+            case OpCode::DIV: return eval(n.a, ctx) / eval(n.b, ctx);
+            case OpCode::POW: return std::pow(eval(n.a, ctx), eval(n.b, ctx)); // 여기서는 볼 수 있듯 ^를 pow로 사용
+            case OpCode::CALL0: return n.fn.f0();
+            case OpCode::CALL1: return n.fn.f1(eval(n.a, ctx));
+            case OpCode::CALL2: return n.fn.f2(eval(n.a, ctx), eval(n.b, ctx));
+            case OpCode::CALL3: return n.fn.f3(eval(n.a, ctx), eval(n.b, ctx), eval(n.c, ctx));
+            case OpCode::SUM:
+            case OpCode::PRODUCT: {
+                int start = static_cast<int>(eval(n.a, ctx));
+                int end   = static_cast<int>(eval(n.b, ctx));
+                if (static_cast<long long>(end) - start + 1 >= 2LL * kReduceChunk)
+                    return reduceChunked(idx, start, end, ctx);
+                bool isSum = (n.op == OpCode::SUM);
+                double result = isSum ? 0.0 : 1.0;
+                for (int i = start; i <= end; ++i) {
+                    ctx.locals[n.slot] = i;
+                    double val = eval(n.c, ctx);
+                    if (isSum) result += val;
+                    else result *= val;
+                }
+                return result;
+            }
+            case OpCode::RAND: return ctx.rng.uniform();
+            case OpCode::RANDN: return ctx.rng.normal();
+            case OpCode::RANDINT: {
+                double lo = std::ceil(eval(n.a, ctx));
+                double hi = std::floor(eval(n.b, ctx));
+                if (hi < lo) return lo;
+                return lo + std::floor(ctx.rng.uniform() * (hi - lo + 1.0));
+            }
+        }
+        throw std::runtime_error("Unknown expression node");
+    }
+
+    double CompiledModel::evalProfiled(int idx, EvalContext& ctx) const {
+        const Node& n = nodes[idx];
+        switch (n.op) {
+            case OpCode::CONST:
+            case OpCode::VAR:
+            case OpCode::LOCAL:
+            case OpCode::CALL0:
+            case OpCode::RAND:
+            case OpCode::RANDN:
+                return eval(idx, ctx); // 잎: 시계를 읽는 비용이 계산보다 크므로 부모의 자기 시간에 포함
+            default: break;
+        }
+
+        ModelProfile& p = *ctx.profile;
+        const std::uint64_t outerNs = p.childNs, outerCalls = p.childCalls, timedBefore = p.timed;
+        p.childNs = 0;
+        p.childCalls = 0;
+        const std::uint64_t begin = ModelProfile::now();
+        double v = 0.0;
+        switch (n.op) {
+            case OpCode::INDEX: {
+                const IndexTable& t = indexTables[n.slot];
+                long k = static_cast<long>(static_cast<int>(evalProfiled(n.a, ctx))) - t.first;
+                if (k < 0 || k >= static_cast<long>(t.slots.size()) || t.slots[k] < 0)
+                    return eval(idx, ctx); // eval과 같은 메시지로 던진다
+                v = ctx.vars[t.slots[k]];
+                break;
+            }
+            case OpCode::NEG: v = -evalProfiled(n.a, ctx); break;
+            case OpCode::ADD: v = evalProfiled(n.a, ctx) + evalProfiled(n.b, ctx); break;
+            case OpCode::SUB: v = evalProfiled(n.a, ctx) - evalProfiled(n.b, ctx); break;
+            case OpCode::MUL: v = evalProfiled(n.a, ctx) * evalProfiled(n.b, ctx); break;
+            case OpCode::DIV: v = evalProfiled(n.a, ctx) / evalProfiled(n.b, ctx); break;
+            case OpCode::POW: v = std::pow(evalProfiled(n.a, ctx), evalProfiled(n.b, ctx)); break;
+            case OpCode::CALL1: v = n.fn.f1(evalProfiled(n.a, ctx)); break;
+            case OpCode::CALL2: v = n.fn.f2(evalProfiled(n.a, ctx), evalProfiled(n.b, ctx)); break;
+            case OpCode::CALL3:
+                v = n.fn.f3(evalProfiled(n.a, ctx), evalProfiled(n.b, ctx), evalProfiled(n.c, ctx));
+                break;
+            case OpCode::SUM:
+            case OpCode::PRODUCT: {
+                int start = static_cast<int>(evalProfiled(n.a, ctx));
+                int end   = static_cast<int>(evalProfiled(n.b, ctx));
+                if (static_cast<long long>(end) - start + 1 >= 2LL * kReduceChunk) {
+                    v = reduceChunked(idx, start, end, ctx);
+                    break;
+                }
+                bool isSum = (n.op == OpCode::SUM);
+                v = isSum ? 0.0 : 1.0;
+                for (int i = start; i <= end; ++i) {
+                    ctx.locals[n.slot] = i;
+                    double val = evalProfiled(n.c, ctx);
+                    if (isSum) v += val;
+                    else v *= val;
+                }
+                break;
+            }
+            case OpCode::RANDINT: {
+                double lo = std::ceil(evalProfiled(n.a, ctx));
+                double hi = std::floor(evalProfiled(n.b, ctx));
+                v = hi < lo ? lo : lo + std::floor(ctx.rng.uniform() * (hi - lo + 1.0));
+                break;
+            }
+            default: throw std::runtime_error("Unknown expression node");
+        }
+        const std::uint64_t spent = ModelProfile::now() - begin;
+
+        ++p.calls[idx];
+        p.totalNs[idx] += spent;
+        p.selfNs[idx] += spent - std::min(spent, p.childNs);
+        p.children[idx] += p.childCalls;
+        p.descendants[idx] += p.timed - timedBefore;
+        ++p.timed;
+        p.childNs = outerNs + spent;
+        p.childCalls = outerCalls + 1;
+        return v;
+    }
+
+    double CompiledModel::evalNode(int idx, EvalContext& ctx) const {
+        return ctx.profile ? evalProfiled(idx, ctx) : eval(idx, ctx);
+    }
+
+    // 대형 sum/product: kReduceChunk 단위 부분 결과를 묶음 순서대로 합친다.
+    // 측정된 손익분기 반복 수를 넘으면 묶음을 공용 스레드 풀에서 병렬로 계산한다.
+    double CompiledModel::reduceChunked(int idx, int start, int end, EvalContext& ctx) const {
+        const Node& n = nodes[idx];
+        const bool isSum = (n.op == OpCode::SUM);
+        const long long trip = static_cast<long long>(end) - start + 1;
+        const std::size_t chunks = static_cast<std::size_t>((trip + kReduceChunk - 1) / kReduceChunk);
+        const std::uint64_t base = ctx.rng.next(); // 묶음 k의 난수 스트림 = deriveStream(base, k)
+
+        std::vector<double> partial(chunks);
+        auto runChunk = [&](std::size_t k, bool nested) {
+            EvalContext local = ctx;
+            local.inParallel = local.inParallel || nested;
+            local.rng.state = deriveStream(base, k);
+            long long lo = start + static_cast<long long>(k) * kReduceChunk;
+            long long hi = std::min<long long>(lo + kReduceChunk - 1, end);
+            double acc = isSum ? 0.0 : 1.0;
+            for (long long i = lo; i <= hi; ++i) {
+                local.locals[n.slot] = static_cast<double>(i);
+                double val = evalNode(n.c, local);
+                if (isSum) acc += val;
+                else acc *= val;
+            }
+            partial[k] = acc;
+        };
+
+        ThreadPool& pool = ThreadPool::shared();
+        long long threshold = -1;
+        // 표본 평가는 직렬로 (기록이 스레드별이고, 시계 비용이 섞인 시간으로 손익분기를 정하지 않도록)
+        const bool measure = !ctx.inParallel && !ctx.profile && parallelThreshold && pool.concurrency() > 1;
+        if (measure)
+            threshold = parallelThreshold[idx].load(std::memory_order_relaxed);
+
+        if (threshold >= 0 && trip >= threshold) {
+            pool.parallelFor(chunks, [&](std::size_t k) { runChunk(k, true); });
+        } else {
+            auto t0 = std::chrono::steady_clock::now();
+            for (std::size_t k = 0; k < chunks; ++k) runChunk(k, false);
+            auto t1 = std::chrono::steady_clock::now();
+
+            if (measure && threshold < 0) {
+                // 첫 평가는 직렬로 돌리며 반복당 시간을 재서 손익분기를 정한다:
+                // 직렬 시간 * (1 - 1/P) 가 분배 비용의 2배를 넘는 반복 수부터 병렬화
+                double nsPerIter = std::max(1e-3, std::chrono::duration<double, std::nano>(t1 - t0).count()
+                                                  / static_cast<double>(trip));
+                double gain = 1.0 - 1.0 / pool.concurrency();
+                double breakEven = 2.0 * pool.dispatchOverheadNs() / (nsPerIter * gain);
+                parallelThreshold[idx].store(
+                        std::max<long long>(2LL * kReduceChunk, static_cast<long long>(std::ceil(breakEven))),
+                        std::memory_order_relaxed);
+            }
+        }
+
+        double result = isSum ? 0.0 : 1.0;
+        for (double p : partial) {
+            if (isSum) result += p;
+            else result *= p;
+        }
+        return result;
+    }
+
+    bool CompiledModel::evalObjectiveBounded(EvalContext& ctx, double cutoff, double& value) const {
+        const CutoffPlan& plan = cutoffPlan;
+        // max는 부호를 뒤집어 min 문제로 취급: 부분합 >= cutoff면 개선 불가
+        const double dir = plan.maximize ? -1.0 : 1.0;
+        const double bound = dir * cutoff;
+
+        // 항 값 (부호 적용 전, 목적식 안의 순서). 중단 판정은 바뀐 순서의 부분합으로 하고 보고 값은 원래 순서로 합친다
+        thread_local std::vector<double> termValues;
+        termValues.resize(plan.terms);
+
+        double partial = 0.0;
+        for (const auto& t : plan.fixed) {
+            double v = evalNode(t.node, ctx);
+            termValues[t.position] = v;
+            partial += t.negated ? -v : v;
+        }
+        if (dir * partial >= bound) return false;
+
+        // 마지막 monotone 항의 마지막 단계 뒤에는 남은 계산이 없으므로 판정하지 않고 끝까지 계산한 값을 돌려준다
+        for (std::size_t m = 0; m < plan.monotone.size(); ++m) {
+            const auto& t = plan.monotone[m];
+            const bool last = m + 1 == plan.monotone.size();
+            const Node& n = nodes[t.node];
+            double sgn = t.negated ? -1.0 : 1.0;
+            if (n.op == OpCode::SUM) {
+                // 긴 sum은 반복마다 확인 (묶음 단위로 계산되는 대형 sum은 통째로 계산 후 확인)
+                int start = static_cast<int>(evalNode(n.a, ctx));
+                int end   = static_cast<int>(evalNode(n.b, ctx));
+                if (static_cast<long long>(end) - start + 1 >= 2LL * kReduceChunk) {
+                    double v = reduceChunked(t.node, start, end, ctx);
+                    termValues[t.position] = v;
+                    partial += sgn * v;
+                    if (!last && dir * partial >= bound) return false;
+                    continue;
+                }
+                double sum = 0.0; // eval의 SUM과 같은 순서로 따로 누적
+                for (int i = start; i <= end; ++i) {
+                    ctx.locals[n.slot] = i;
+                    double v = evalNode(n.c, ctx);
+                    sum += v;
+                    partial += sgn * v;
+                    if ((!last || i < end) && dir * partial >= bound) return false;
+                }
+                termValues[t.position] = sum;
+            } else {
+                double v = evalNode(t.node, ctx);
+                termValues[t.position] = v;
+                partial += sgn * v;
+                if (!last && dir * partial >= bound) return false;
+            }
+        }
+        const double* next = termValues.data();
+        value = combineTerms(objective, next);
+        return true;
+    }
+
+    double CompiledModel::combineTerms(int idx, const double*& next) const {
+        const Node& n = nodes[idx];
+        switch (n.op) {
+            case OpCode::ADD: {
+                double a = combineTerms(n.a, next);
+                return a + combineTerms(n.b, next);
+            }
+            case OpCode::SUB: {
+                double a = combineTerms(n.a, next);
+                return a - combineTerms(n.b, next);
+            }
+            case OpCode::NEG: return -combineTerms(n.a, next);
+            default: return *next++; // flattenTerms와 같은 순서
+        }
+    }
+
+    // 제약조건 평가 (true=만족, false=위반)
+    bool CompiledModel::satisfies(const CompiledConstraint& c, EvalContext& ctx) const {
+        double left, right;
+        evalSides(c, ctx, left, right);
+        switch (c.comparator) {
+            case TokenType::LEQ: return left <= right;
+            case TokenType::GEQ: return left >= right;
+            case TokenType::EQ:  return std::fabs(left - right) < eqTolerance; // 배정밀도 오차 보정
+            case TokenType::NEQ: return std::fabs(left - right) >= 1e-9;
+            case TokenType::LT:  return left < right;
+            case TokenType::GT:  return left > right;
+            default: throw std::runtime_error("Unsupported comparator");
+        }
+    }
+
+    double CompiledModel::violation(const CompiledConstraint& c, EvalContext& ctx) const {
+        double left, right;
+        evalSides(c, ctx, left, right);
+        double v;
+        switch (c.comparator) {
+            case TokenType::LEQ: return std::max(0.0, left - right);
+            case TokenType::GEQ: return std::max(0.0, right - left);
+            case TokenType::EQ:  v = std::fabs(left - right); return v < eqTolerance ? 0.0 : v;
+            case TokenType::NEQ: return std::fabs(left - right) >= 1e-9 ? 0.0 : 1e-9;
+            // 경계값 자체도 위반이므로 아주 작은 양수를 보장
+            case TokenType::LT:  return left < right ? 0.0 : std::max(left - right, 1e-12);
+            case TokenType::GT:  return left > right ? 0.0 : std::max(right - left, 1e-12);
+            default: throw std::runtime_error("Unsupported comparator");
+        }
+    }
+
+    void CompiledModel::evalSides(const CompiledConstraint& c, EvalContext& ctx, double& left, double& right) const {
+        if (!ctx.profile) {
+            left = eval(c.left, ctx);
+            right = eval(c.right, ctx);
+            return;
+        }
+        // c는 constraints의 원소 (모든 호출부가 model->constraints를 넘긴다)
+        ModelProfile::Span span(*ctx.profile, ctx.profile->constraints[static_cast<std::size_t>(&c - constraints.data())]);
+        left = evalProfiled(c.left, ctx);
+        right = evalProfiled(c.right, ctx);
+    }
+
+    void CompiledModel::repairEqualities(double* vars) const {
+        for (const auto& r : equalityRepairs) repairEquality(r, vars);
+    }
+
+    void CompiledModel::repairEquality(const EqualityRepair& r, double* vars) const {
+        EvalContext ctx;
+        ctx.vars = vars;
+        const auto& c = constraints[r.constraint];
+        double& v = vars[r.pivot];
+        const double v0 = v;
+        double f0 = eval(c.left, ctx) - eval(c.right, ctx);
+        if (f0 == 0.0 || !std::isfinite(f0)) return;
+        v = v0 + 1.0;
+        double slope = eval(c.left, ctx) - eval(c.right, ctx) - f0;
+        if (slope == 0.0 || !std::isfinite(slope)) {
+            v = v0; // 다른 변수 값 때문에 기울기가 0이면 풀 수 없음
+            return;
+        }
+        v = std::clamp(v0 - f0 / slope, r.lower, r.upper);
+    }
+
+    double CompiledModel::evalSlice(const ObjectiveSlice& s, EvalContext& ctx) const {
+        double v;
+        if (s.local < 0) {
+            v = eval(s.node, ctx);
+        } else {
+            ctx.locals[s.local] = s.index;
+            v = eval(nodes[s.node].c, ctx);
+        }
+        return s.negated ? -v : v;
+    }
+
+    Compiler::Compiler(CompiledModel& model, const std::vector<Variable>& variables)
+            : model(model), variables(variables) {}
+
+    int Compiler::signOf(int idx) const {
+        const Node& n = model.nodes[idx];
+        auto bothSame = [](int x, int y) { return (x != 0 && x == y) ? x : 0; };
+        switch (n.op) {
+            case OpCode::CONST: return n.value >= 0.0 ? 1 : -1;
+            case OpCode::VAR: {
+                const auto& r = variables[n.slot].range;
+                if (r.first >= 0.0) return 1;
+                if (r.second <= 0.0) return -1;
+                return 0;
+            }
+            case OpCode::INDEX: {
+                int s = 0;
+                for (int slot : model.indexTables[n.slot].slots) {
+                    if (slot < 0) continue;
+                    const auto& r = variables[slot].range;
+                    int vs = r.first >= 0.0 ? 1 : (r.second <= 0.0 ? -1 : 0);
+                    if (vs == 0 || (s != 0 && vs != s)) return 0;
+                    s = vs;
+                }
+                return s;
+            }
+            case OpCode::NEG: return -signOf(n.a);
+            case OpCode::ADD: return bothSame(signOf(n.a), signOf(n.b));
+            case OpCode::SUB: return bothSame(signOf(n.a), -signOf(n.b));
+            case OpCode::MUL:
+            case OpCode::DIV: return signOf(n.a) * signOf(n.b);
+            case OpCode::POW: {
+                const Node& e = model.nodes[n.b];
+                if (e.op == OpCode::CONST && std::fmod(e.value, 2.0) == 0.0) return 1; // x^2, x^4 ...
+                return signOf(n.a) > 0 ? 1 : 0;
+            }
+            case OpCode::CALL1: return n.fn.nonNegative ? 1 : 0;
+            case OpCode::SUM: return signOf(n.c);
+            case OpCode::PRODUCT: return signOf(n.c) > 0 ? 1 : 0;
+            case OpCode::RAND: return 1;
+            case OpCode::RANDINT: return signOf(n.a) > 0 ? 1 : (signOf(n.b) < 0 ? -1 : 0);
+            default: return 0;
+        }
+    }
+
+    void Compiler::flattenTerms(int idx, bool negated, std::vector<ObjectiveTerm>& out) const {
+        const Node& n = model.nodes[idx];
+        if (n.op == OpCode::ADD) {
+            flattenTerms(n.a, negated, out);
+            flattenTerms(n.b, negated, out);
+        } else if (n.op == OpCode::SUB) {
+            flattenTerms(n.a, negated, out);
+            flattenTerms(n.b, !negated, out);
+        } else if (n.op == OpCode::NEG) {
+            flattenTerms(n.a, !negated, out);
+        } else {
+            out.push_back({idx, negated});
+        }
+    }
+
+    void Compiler::buildCutoffPlan(bool maximize) {
+        CutoffPlan plan;
+        plan.maximize = maximize;
+        std::vector<ObjectiveTerm> terms;
+        if (usesRandom(model.objective)) {
+            model.cutoffPlan = std::move(plan); // 빈 계획 (usable() == false)
+            return;
+        }
+        flattenTerms(model.objective, false, terms);
+        plan.terms = terms.size();
+        for (std::size_t i = 0; i < terms.size(); ++i) terms[i].position = static_cast<int>(i);
+
+        // 목적값을 나쁜 쪽으로만 움직이는 항: min이면 >= 0, max면 <= 0
+        const int worsening = maximize ? -1 : 1;
+        for (const auto& t : terms) {
+            int s = signOf(t.node) * (t.negated ? -1 : 1);
+            if (s == worsening && usesVariables(t.node)) plan.monotone.push_back(t);
+            else plan.fixed.push_back(t);
+        }
+        model.cutoffPlan = std::move(plan);
+    }
+
+    bool Compiler::usesRandom(int idx) const {
+        const Node& n = model.nodes[idx];
+        if (n.op == OpCode::RAND || n.op == OpCode::RANDN || n.op == OpCode::RANDINT) return true;
+        for (int child : {n.a, n.b, n.c})
+            if (child >= 0 && usesRandom(child)) return true;
+        return false;
+    }
+
+    bool Compiler::usesVariables(int idx) const {
+        const Node& n = model.nodes[idx];
+        if (n.op == OpCode::VAR || n.op == OpCode::INDEX) return true;
+        for (int child : {n.a, n.b, n.c})
+            if (child >= 0 && usesVariables(child)) return true;
+        return false;
+    }
+
+    int Compiler::affinity(int idx, int slot) const {
+        const Node& n = model.nodes[idx];
+        switch (n.op) {
+            case OpCode::CONST:
+            case OpCode::LOCAL: return 0;
+            case OpCode::VAR: return n.slot == slot ? 1 : 0;
+            case OpCode::INDEX: {
+                if (int fixed = fixedIndexSlot(n); fixed != -2) return fixed == slot ? 1 : 0;
+                const auto& slots = model.indexTables[n.slot].slots;
+                if (std::find(slots.begin(), slots.end(), slot) == slots.end()) return 0;
+                return affinity(n.a, slot) == 0 ? 1 : 2; // x[i]는 slot 자신이거나 다른 변수
+            }
+            case OpCode::NEG: return affinity(n.a, slot);
+            case OpCode::ADD:
+            case OpCode::SUB: return std::max(affinity(n.a, slot), affinity(n.b, slot));
+            case OpCode::MUL: {
+                int ka = affinity(n.a, slot), kb = affinity(n.b, slot);
+                if (ka == 0) return kb;
+                return kb == 0 ? ka : 2;
+            }
+            case OpCode::DIV: return affinity(n.b, slot) == 0 ? affinity(n.a, slot) : 2;
+            case OpCode::POW: {
+                int ka = affinity(n.a, slot), kb = affinity(n.b, slot);
+                if (ka == 0 && kb == 0) return 0;
+                const Node& e = model.nodes[n.b];
+                return (ka == 1 && e.op == OpCode::CONST && e.value == 1.0) ? 1 : 2;
+            }
+            case OpCode::CALL0: return 0;
+            case OpCode::CALL1:
+            case OpCode::CALL2:
+            case OpCode::CALL3: {
+                for (int child : {n.a, n.b, n.c})
+                    if (child >= 0 && affinity(child, slot) != 0) return 2;
+                return 0;
+            }
+            case OpCode::SUM:
+            case OpCode::PRODUCT: {
+                if (affinity(n.a, slot) != 0 || affinity(n.b, slot) != 0) return 2;
+                int kc = affinity(n.c, slot);
+                return (n.op == OpCode::SUM || kc == 0) ? kc : 2;
+            }
+            default: return 2; // 난수: 보정과 검사에서 값이 달라지므로 풀지 않는다
+        }
+    }
+
+    std::vector<int> Compiler::variablesOf(int left, int right) const {
+        std::vector<char> used(variables.size(), 0);
+        collectVariables(left, used);
+        collectVariables(right, used);
+        std::vector<int> out;
+        for (std::size_t v = 0; v < used.size(); ++v)
+            if (used[v]) out.push_back(static_cast<int>(v));
+        return out;
+    }
+
+    // 첨자가 상수인 x[k]가 가리키는 변수 번호 (없는 k면 -1). 첨자가 상수가 아니면 -2
+    int Compiler::fixedIndexSlot(const Node& n) const {
+        const Node& index = model.nodes[n.a];
+        if (index.op != OpCode::CONST) return -2;
+        const auto& table = model.indexTables[n.slot];
+        long k = static_cast<long>(static_cast<int>(index.value)) - table.first; // eval과 같은 절사
+        return (k >= 0 && k < static_cast<long>(table.slots.size())) ? table.slots[static_cast<std::size_t>(k)] : -1;
+    }
+
+    void Compiler::collectVariables(int idx, std::vector<char>& used) const {
+        const Node& n = model.nodes[idx];
+        if (n.op == OpCode::VAR) used[n.slot] = 1;
+        if (n.op == OpCode::INDEX) {
+            if (int fixed = fixedIndexSlot(n); fixed != -2) {
+                if (fixed >= 0) used[fixed] = 1;
+            } else {
+                for (int slot : model.indexTables[n.slot].slots)
+                    if (slot >= 0) used[slot] = 1;
+            }
+        }
+        for (int child : {n.a, n.b, n.c})
+            if (child >= 0) collectVariables(child, used);
+    }
+
+    // 결정 변수/난수 없이 상수와 앞의 known개 지역 슬롯만으로 계산되는 식인지
+    bool Compiler::localOnly(int idx, int known) const {
+        const Node& n = model.nodes[idx];
+        switch (n.op) {
+            case OpCode::CONST: return true;
+            case OpCode::LOCAL: return n.slot < known;
+            case OpCode::VAR: case OpCode::INDEX: case OpCode::SUM: case OpCode::PRODUCT:
+            case OpCode::RAND: case OpCode::RANDN: case OpCode::RANDINT: return false;
+            default: break;
+        }
+        for (int child : {n.a, n.b, n.c})
+            if (child >= 0 && !localOnly(child, known)) return false;
+        return true;
+    }
+
+    // collectVariables와 같되, 값이 정해진 지역 슬롯(앞의 known개, ctx.locals)으로 x[i]의 첨자를 계산한다.
+    // 첨자를 계산할 수 없는 x[...]를 만나면 배열 전체를 넣고 false
+    bool Compiler::collectVariablesAt(int idx, EvalContext& ctx, int known, std::vector<int>& out) const {
+        const Node& n = model.nodes[idx];
+        bool exact = true;
+        if (n.op == OpCode::VAR) out.push_back(n.slot);
+        if (n.op == OpCode::INDEX) {
+            const auto& table = model.indexTables[n.slot];
+            if (localOnly(n.a, known)) {
+                long k = static_cast<long>(static_cast<int>(model.eval(n.a, ctx))) - table.first;
+                if (k >= 0 && k < static_cast<long>(table.slots.size()) && table.slots[static_cast<std::size_t>(k)] >= 0)
+                    out.push_back(table.slots[static_cast<std::size_t>(k)]);
+            } else {
+                for (int slot : table.slots)
+                    if (slot >= 0) out.push_back(slot);
+                exact = false;
+            }
+        }
+        for (int child : {n.a, n.b, n.c})
+            if (child >= 0 && !collectVariablesAt(child, ctx, known, out)) exact = false;
+        return exact;
+    }
+
+    // 목적식을 더하기 항으로 펼치고, 범위가 상수인 최상위 sum은 반복 하나를 한 조각으로 나눈다.
+    // 조각의 변수를 미리 모아 두면 협력 공진화에서 한 묶음에 관련된 조각만 다시 계산할 수 있다.
+    // body의 첨자를 반복 번호로 정할 수 없는 sum(중첩 sum 등)은 나누지 않고 한 조각으로 둔다.
+    void Compiler::planDecomposition() {
+        constexpr long long kMaxSlices = 1LL << 22;
+        auto finish = [](std::vector<int>& v) {
+            std::sort(v.begin(), v.end());
+            v.erase(std::unique(v.begin(), v.end()), v.end());
+        };
+
+        std::vector<ObjectiveTerm> terms;
+        flattenTerms(model.objective, false, terms);
+        EvalContext ctx;
+        for (const auto& t : terms) {
+            const Node& n = model.nodes[t.node];
+            if (n.op == OpCode::SUM && localOnly(n.a, n.slot) && localOnly(n.b, n.slot)) {
+                long long start = static_cast<int>(model.eval(n.a, ctx));
+                long long end = static_cast<int>(model.eval(n.b, ctx));
+                const std::size_t first = model.slices.size();
+                bool exact = end - start + 1 <= kMaxSlices;
+                for (long long i = start; exact && i <= end; ++i) {
+                    ObjectiveSlice s{t.node, t.negated, n.slot, static_cast<int>(i), {}};
+                    ctx.locals[n.slot] = static_cast<double>(i);
+                    exact = collectVariablesAt(n.c, ctx, n.slot + 1, s.variables);
+                    finish(s.variables);
+                    model.slices.push_back(std::move(s));
+                }
+                if (exact) continue;
+                model.slices.resize(first);
+            }
+            ObjectiveSlice s{t.node, t.negated, -1, 0, {}};
+            collectVariablesAt(t.node, ctx, 0, s.variables);
+            finish(s.variables);
+            model.slices.push_back(std::move(s));
+        }
+    }
+
+    // 연속 변수 하나에 대해 1차인 등식마다 그 변수를 기준 변수로 정한다.
+    // 나중에 푸는 등식의 기준 변수가 먼저 푼 등식에 나타나면 앞의 등식이 다시 깨지므로,
+    // 남은 어떤 등식에도 나타나지 않는 기준 변수를 가진 등식을 맨 뒤로 보내는 식으로 순서를 정한다.
+    // 기준 변수를 정하지 못한 등식은 eqTolerance 기준의 위반 정도로만 다룬다.
+    void Compiler::planEqualityRepairs() {
+        struct Pending {
+            int constraint;
+            std::vector<char> used;
+        };
+        std::vector<Pending> pending;
+        for (std::size_t i = 0; i < model.constraints.size(); ++i) {
+            const auto& c = model.constraints[i];
+            if (c.comparator != TokenType::EQ) continue;
+            Pending p{static_cast<int>(i), std::vector<char>(variables.size(), 0)};
+            collectVariables(c.left, p.used);
+            collectVariables(c.right, p.used);
+            pending.push_back(std::move(p));
+        }
+
+        std::vector<EqualityRepair> reversed;
+        for (bool progress = true; progress && !pending.empty();) {
+            progress = false;
+            for (std::size_t e = 0; e < pending.size() && !progress; ++e) {
+                const auto& c = model.constraints[pending[e].constraint];
+                for (std::size_t v = 0; v < variables.size(); ++v) {
+                    if (!pending[e].used[v] || variables[v].isInt) continue;
+                    bool elsewhere = false;
+                    for (std::size_t o = 0; o < pending.size() && !elsewhere; ++o)
+                        elsewhere = o != e && pending[o].used[v];
+                    if (elsewhere) continue;
+                    int slot = static_cast<int>(v);
+                    if (std::max(affinity(c.left, slot), affinity(c.right, slot)) != 1) continue;
+
+                    reversed.push_back({pending[e].constraint, slot, variables[v].range.first, variables[v].range.second});
+                    pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(e));
+                    progress = true;
+                    break;
+                }
+            }
+        }
+        model.equalityRepairs.assign(reversed.rbegin(), reversed.rend());
+    }
+
+    int Compiler::emit(const Node& n) {
+        model.nodes.push_back(n);
+        model.sources.push_back(here);
+        return static_cast<int>(model.nodes.size()) - 1;
+    }
+
+    int Compiler::lookupLocal(const std::string& name) const {
+        for (int d = static_cast<int>(scope.size()) - 1; d >= 0; --d)
+            if (scope[d] == name) return d;
+        return -1;
+    }
+
+    int Compiler::lookupVariable(const std::string& name) const {
+        for (size_t i = 0; i < variables.size(); ++i)
+            if (variables[i].name == name) return static_cast<int>(i);
+        return -1;
+    }
+
+    int Compiler::indexTableFor(const std::string& base) {
+        for (size_t t = 0; t < model.indexTables.size(); ++t)
+            if (model.indexTables[t].name == base) return static_cast<int>(t);
+
+        // base[k] 꼴로 펼쳐진 변수들을 모아 k -> 변수 번호 표를 만든다.
+        IndexTable table;
+        table.name = base;
+        std::vector<std::pair<int, int>> found;
+        const std::string prefix = base + "[";
+        for (size_t i = 0; i < variables.size(); ++i) {
+            const auto& name = variables[i].name;
+            if (name.size() > prefix.size() + 1 && name.compare(0, prefix.size(), prefix) == 0 && name.back() == ']') {
+                try {
+                    int k = std::stoi(name.substr(prefix.size(), name.size() - prefix.size() - 1));
+                    found.emplace_back(k, static_cast<int>(i));
+                } catch (...) {}
+            }
+        }
+        if (!found.empty()) {
+            int lo = found.front().first, hi = lo;
+            for (auto& [k, _] : found) { lo = std::min(lo, k); hi = std::max(hi, k); }
+            table.first = lo;
+            table.slots.assign(static_cast<size_t>(hi - lo) + 1, -1);
+            for (auto& [k, slot] : found) table.slots[k - lo] = slot;
+        }
+
+        model.indexTables.push_back(std::move(table));
+        return static_cast<int>(model.indexTables.size()) - 1;
+    }
+
+    int Compiler::compile(Expression* expr) {
+        // 자식을 컴파일하는 동안 바뀐 위치를 되돌려 이 식의 노드가 자기 위치로 기록되게 한다
+        const SourcePos outer = here;
+        here = {expr->line, expr->column};
+        int idx = compileNode(expr);
+        here = outer;
+        return idx;
+    }
+
+    int Compiler::compileNode(Expression* expr) {
+        if (auto num = dynamic_cast<NumberExpr*>(expr)) {
+            Node n; n.op = OpCode::CONST; n.value = num->value;
+            return emit(n);
+        }
+        else if (auto id = dynamic_cast<IdentExpr*>(expr)) {
+            Node n;
+            // 내장 상수의 경우(ex: e, pi)
+            const auto& K = hsl::builtinConstants();
+            if (auto it = K.find(id->name); it != K.end()) {
+                n.op = OpCode::CONST; n.value = it->second;
+                return emit(n);
+            }
+            // sum/product 인덱스 변수가 결정 변수보다 우선
+            if (int d = lookupLocal(id->name); d >= 0) {
+                n.op = OpCode::LOCAL; n.slot = d;
+                return emit(n);
+            }
+            if (int v = lookupVariable(id->name); v >= 0) {
+                n.op = OpCode::VAR; n.slot = v;
+                return emit(n);
+            }
+            throw std::runtime_error("Undefined variable: " + id->name);
+        }
+        else if (auto un = dynamic_cast<UnaryExpr*>(expr)) {
+            int operand = compile(un->expr);
+            switch (un->op) {
+                case TokenType::MINUS: { Node n; n.op = OpCode::NEG; n.a = operand; return emit(n); }
+                case TokenType::PLUS: return operand;
+                default: throw std::runtime_error("Unsupported unary op");
+            }
+        } // 음수 양수.
+        else if (auto bin = dynamic_cast<BinaryExpr*>(expr)) {
+            Node n;
+            switch (bin->op) {
+                case TokenType::PLUS: n.op = OpCode::ADD; break;
+                case TokenType::MINUS: n.op = OpCode::SUB; break;
+                case TokenType::ASTERISK: n.op = OpCode::MUL; break;
+                case TokenType::SLASH: n.op = OpCode::DIV; break;
+                case TokenType::CARET: n.op = OpCode::POW; break;
+                default: throw std::runtime_error("Unsupported binary op");
+            }
+            n.a = compile(bin->left);
+            n.b = compile(bin->right);
+            return emit(n);
+        }
+        else if (auto call = dynamic_cast<FunctionCallExpr*>(expr)) {
+            return compileCall(call);
+        }
+        else if (auto idx = dynamic_cast<IndexExpr*>(expr)) {
+            Node n; n.op = OpCode::INDEX;
+            n.a = compile(idx->index);
+            n.slot = indexTableFor(idx->name);
+            return emit(n);
+        }
+
+        throw std::runtime_error("Unknown expression node");
+    }
+
+    int Compiler::compileCall(FunctionCallExpr* call) {
+        // 내장 함수 중 sum(sigma)와 product(pi)는 인덱스 변수를 갖는 특수 노드로 컴파일.
+        if (call->name == "sum" || call->name == "product") {
+            if (call->args.size() != 4)
+                throw std::runtime_error(call->name + "() expects 4 arguments: (i, start, end, expr)");
+
+            auto* idExpr = dynamic_cast<IdentExpr*>(call->args[0]);
+            if (!idExpr)
+                throw std::runtime_error(call->name + "(): first argument must be an identifier");
+            if (static_cast<int>(scope.size()) >= kMaxLocals)
+                throw std::runtime_error(call->name + "(): nested too deeply (max " + std::to_string(kMaxLocals) + ")");
+
+            Node n;
+            n.op = (call->name == "sum") ? OpCode::SUM : OpCode::PRODUCT;
+            n.a = compile(call->args[1]);
+            n.b = compile(call->args[2]);
+            n.slot = static_cast<int>(scope.size());
+            scope.push_back(idExpr->name);
+            n.c = compile(call->args[3]);
+            scope.pop_back();
+            return emit(n);
+        }
+
+        // 난수 함수는 전역 상태 대신 평가 컨텍스트의 스트림을 사용해야 하므로 별도 노드로 컴파일.
+        if (call->name == "rand" || call->name == "randn" || call->name == "randint") {
+            size_t expected = (call->name == "randint") ? 2 : 0;
+            if (call->args.size() != expected)
+                throw std::runtime_error(call->name + "() expects " + std::to_string(expected) +
+                                         " argument(s), got " + std::to_string(call->args.size()));
+            Node n;
+            if (call->name == "rand") n.op = OpCode::RAND;
+            else if (call->name == "randn") n.op = OpCode::RANDN;
+            else {
+                n.op = OpCode::RANDINT;
+                n.a = compile(call->args[0]);
+                n.b = compile(call->args[1]);
+            }
+            model.stochastic = true;
+            return emit(n);
+        }
+
+        //나머지 내장함수는 이름 -> 함수 포인터로 여기서 한 번만 해석.
+        const BuiltinFunc* f = hsl::findBuiltin(call->name);
+        if (!f) {
+            throw std::runtime_error("Unknown function: " + call->name);
+        }
+        if (static_cast<int>(call->args.size()) != f->arity) {
+            throw std::runtime_error(call->name + "() expects " + std::to_string(f->arity) +
+                                     " argument(s), got " + std::to_string(call->args.size()));
+        }
+
+        Node n;
+        n.fn = *f;
+        static constexpr OpCode callOps[] = {OpCode::CALL0, OpCode::CALL1, OpCode::CALL2, OpCode::CALL3};
+        n.op = callOps[f->arity];
+        if (f->arity > 0) n.a = compile(call->args[0]);
+        if (f->arity > 1) n.b = compile(call->args[1]);
+        if (f->arity > 2) n.c = compile(call->args[2]);
+        int idx = emit(n);
+        model.functions.emplace_back(idx, call->name);
+        return idx;
+    }
+
+    CompiledModel compileModel(Program* program, const std::vector<Variable>& variables, double eqTolerance,
+                               bool decompose) {
+        CompiledModel model;
+        model.eqTolerance = eqTolerance;
+        Compiler compiler(model, variables);
+
+        // external 목적 함수는 식이 없으므로 objective = -1 (조기 중단/분해 계획도 없음)
+        const bool external = program->obj->expr == nullptr;
+        if (!external) {
+            model.objective = compiler.compile(program->obj->expr);
+            compiler.buildCutoffPlan(program->obj->isMax);
+        }
+        for (auto* c : program->constraints) {
+            int l = compiler.compile(c->left);
+            int r = compiler.compile(c->right);
+            model.constraints.push_back({l, r, c->comparator, compiler.variablesOf(l, r), {c->line, c->column}});
+        }
+        compiler.planEqualityRepairs();
+        if (decompose && !external) compiler.planDecomposition();
+
+        model.parallelThreshold = std::make_unique<std::atomic<long long>[]>(model.nodes.size());
+        for (std::size_t i = 0; i < model.nodes.size(); ++i) model.parallelThreshold[i].store(-1);
+        return model;
+    }
+
+    double evalConstantExpr(Expression* expr) {
+        static const std::vector<Variable> none;
+        CompiledModel model;
+        Compiler compiler(model, none);
+        int root = compiler.compile(expr);
+        EvalContext ctx;
+        return model.eval(root, ctx);
+    }
+
+}
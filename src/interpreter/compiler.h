@@ -0,0 +1,199 @@
+#ifndef HSL_COMPILER_
+#define HSL_COMPILER_
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "func.h"
+#include "evaluator.h"
+#include "../utils/random.h"
+
+namespace hsl {
+
+    struct ModelProfile;
+
+    // AST를 평가 전용의 평탄한 노드 배열로 변환한 형태.
+    // 이름 해석(변수 슬롯, 내장 함수 포인터, 인자 개수 검사)은 컴파일 시 한 번만 수행한다.
+    enum class OpCode : unsigned char {
+        CONST,      // value
+        VAR,        // 결정 변수, slot = 변수 번호
+        LOCAL,      // sum/product의 인덱스 변수, slot = 지역 슬롯
+        INDEX,      // x[i], slot = 인덱스 테이블 번호, a = 인덱스 식
+        NEG,
+        ADD, SUB, MUL, DIV, POW,
+        CALL0, CALL1, CALL2, CALL3,
+        SUM, PRODUCT, // slot = 지역 슬롯, a = start, b = end, c = body
+        RAND, RANDN,  // 컨텍스트 난수 스트림 사용
+        RANDINT,      // a = lo, b = hi (양끝 포함)
+    };
+
+    struct Node {
+        OpCode op = OpCode::CONST;
+        int slot = -1;
+        int a = -1, b = -1, c = -1; // 자식 노드 인덱스
+        double value = 0.0;
+        BuiltinFunc fn{};
+    };
+
+    // 노드를 만든 식의 소스 위치 (줄/열은 1부터, 0이면 모름)
+    struct SourcePos {
+        int line = 0;
+        int column = 0;
+    };
+
+    // x[k] 형태로 선언된 변수들의 k -> 변수 번호 매핑 (없는 k는 -1)
+    struct IndexTable {
+        std::string name;
+        int first = 0;
+        std::vector<int> slots;
+    };
+
+    struct CompiledConstraint {
+        int left = -1;
+        int right = -1;
+        TokenType comparator;
+        std::vector<int> variables; // 식에 나타나는 결정 변수 번호 (오름차순)
+        SourcePos source;           // [ST] 위치
+    };
+
+    // 등식 제약 constraint를 기준 변수 pivot에 대해 닫힌 형태로 푸는 보정 단계.
+    // 제약식이 pivot에 대해 1차이므로 현재 값 v와 v+1에서의 차이로 기울기를 구해 근을 바로 얻는다.
+    struct EqualityRepair {
+        int constraint = -1;
+        int pivot = -1;
+        double lower = 0.0, upper = 0.0; // pivot의 범위 (근이 벗어나면 경계로 자르고 남은 위반은 패널티로)
+    };
+
+    struct ObjectiveTerm {
+        int node = -1;
+        bool negated = false;
+        int position = -1; // 목적식 안에서 몇 번째 항인지 (CutoffPlan에서만 채움)
+    };
+
+    // 목적식을 최상위 덧셈 항으로 펼친 결과.
+    // monotone 항은 최적화 방향의 반대로만 움직이므로(min: >= 0, max: <= 0),
+    // fixed 항을 먼저 더한 뒤 부분합이 cutoff에 도달하면 그 후보는 더 이상 개선될 수 없다.
+    // 끝까지 평가한 값은 항 값을 목적식의 원래 덧셈 구조로 다시 합쳐 eval과 비트 단위로 같게 한다.
+    // 목적식이 난수 함수를 쓰면 항 순서를 바꾸면 스트림 소비 순서가 달라지므로 계획을 만들지 않는다
+    struct CutoffPlan {
+        std::vector<ObjectiveTerm> fixed;
+        std::vector<ObjectiveTerm> monotone;
+        std::size_t terms = 0; // fixed + monotone 항 수
+        bool maximize = false;
+        [[nodiscard]] bool usable() const { return !monotone.empty(); }
+    };
+
+    // 협력 공진화용 목적식 분해 단위. 목적식 = 모든 조각의 합 (negated면 부호 반대).
+    // local < 0이면 node의 값 하나, 아니면 sum 노드 node의 body를 지역 슬롯 local = index로 평가한 한 항
+    struct ObjectiveSlice {
+        int node = -1;
+        bool negated = false;
+        int local = -1;
+        int index = 0;
+        std::vector<int> variables; // 이 조각에 나타나는 결정 변수 번호 (오름차순)
+    };
+
+    // sum/product 중첩 깊이 한도. 지역 변수는 깊이별 슬롯을 재사용한다.
+    constexpr int kMaxLocals = 16;
+
+    // 반복 수가 이 값의 2배 이상인 sum/product는 이 크기의 묶음별 부분 결과를 순서대로 합친다.
+    // 묶음 경계가 스레드 수와 무관하므로 직렬/병렬 어느 쪽으로 계산해도 결과가 비트 단위로 같다.
+    constexpr int kReduceChunk = 4096;
+
+    struct EvalContext {
+        const double* vars = nullptr;
+        std::array<double, kMaxLocals> locals;
+        SplitMix64 rng; // rand()/randn()/randint() 전용. 평가 1회마다 deriveStream()으로 재설정.
+        bool inParallel = false; // 이미 스레드 풀 작업 안이면 중첩 병렬화하지 않음
+        ModelProfile* profile = nullptr; // 표본 평가면 노드/제약별 시간을 여기에 기록 (--profile-model)
+    };
+
+    class CompiledModel {
+    public:
+        std::vector<Node> nodes;
+        std::vector<SourcePos> sources; // nodes와 같은 순서 (평가에는 쓰지 않으므로 Node와 분리)
+        std::vector<std::pair<int, std::string>> functions; // CALL 노드 번호와 내장 함수 이름 (모델 해시용)
+        std::vector<IndexTable> indexTables;
+        int objective = -1;
+        std::vector<CompiledConstraint> constraints;
+        bool stochastic = false; // 난수 내장 함수 사용 여부
+        CutoffPlan cutoffPlan;
+        double eqTolerance = 1e-9;  // |l - r|이 이 값 미만이면 등식 만족
+        std::vector<EqualityRepair> equalityRepairs; // 적용 순서대로
+        std::vector<ObjectiveSlice> slices;          // 분해를 요청한 경우에만 채움
+        // sum/product 노드별 병렬 전환 반복 수 (-1: 아직 측정 전). 첫 대형 평가에서 측정해 채운다.
+        std::unique_ptr<std::atomic<long long>[]> parallelThreshold;
+
+        double eval(int idx, EvalContext& ctx) const;
+        // eval과 같은 값/난수 소비로 계산하며 잎이 아닌 노드마다 시간을 ctx.profile에 더한다 (대형 sum도 직렬)
+        double evalProfiled(int idx, EvalContext& ctx) const;
+        // cutoff(HM worst 등)보다 나아질 수 없다고 판명되면 중간에 멈추고 false. 끝까지 평가하면 value를 채우고 true.
+        bool evalObjectiveBounded(EvalContext& ctx, double cutoff, double& value) const;
+        bool satisfies(const CompiledConstraint& c, EvalContext& ctx) const;
+        // 위반 크기 (만족하면 0). <=, >= 는 max(0, 차이), = 는 |l - r|
+        double violation(const CompiledConstraint& c, EvalContext& ctx) const;
+        // equalityRepairs를 순서대로 적용해 vars의 기준 변수들을 덮어쓴다
+        void repairEqualities(double* vars) const;
+        void repairEquality(const EqualityRepair& r, double* vars) const;
+        double evalSlice(const ObjectiveSlice& s, EvalContext& ctx) const;
+
+    private:
+        double reduceChunked(int idx, int start, int end, EvalContext& ctx) const;
+        // 목적식의 덧셈 뼈대(ADD/SUB/NEG)를 eval과 같은 순서로 따라가며 항 값을 차례로 꺼내 합친다
+        double combineTerms(int idx, const double*& next) const;
+        // ctx.profile이 있으면 evalProfiled, 없으면 eval
+        double evalNode(int idx, EvalContext& ctx) const;
+        // 제약의 양변. 표본 평가면 제약별 시간도 기록
+        void evalSides(const CompiledConstraint& c, EvalContext& ctx, double& left, double& right) const;
+    };
+
+    // 선언된 변수 목록을 기준으로 식을 컴파일. 미정의 변수/함수, 인자 개수 오류는 여기서 예외로 던진다.
+    class Compiler {
+    public:
+        Compiler(CompiledModel& model, const std::vector<Variable>& variables);
+        int compile(Expression* expr);
+        // 노드 값의 부호를 정적으로 판정: +1 (항상 >= 0), -1 (항상 <= 0), 0 (알 수 없음)
+        int signOf(int idx) const;
+        // 노드 아래에 rand/randn/randint가 있는지
+        bool usesRandom(int idx) const;
+        // 노드 아래에 결정 변수(VAR/INDEX)가 있는지. 없으면 값이 상수라 중단 판정의 근거가 되지 못한다
+        bool usesVariables(int idx) const;
+        void buildCutoffPlan(bool maximize);
+        // 노드 값이 변수 slot에 대해: 0 (무관), 1 (1차), 2 (그 외/판정 불가)
+        int affinity(int idx, int slot) const;
+        void planEqualityRepairs();
+        void planDecomposition();
+        std::vector<int> variablesOf(int left, int right) const;
+
+    private:
+        CompiledModel& model;
+        const std::vector<Variable>& variables;
+        std::vector<std::string> scope; // 현재 열린 sum/product 인덱스 변수 (깊이 = 슬롯)
+        SourcePos here;                 // 컴파일 중인 식의 위치 (emit이 sources에 기록)
+
+        int emit(const Node& n);
+        int compileNode(Expression* expr);
+        int lookupLocal(const std::string& name) const;
+        int lookupVariable(const std::string& name) const;
+        int indexTableFor(const std::string& base);
+        int compileCall(FunctionCallExpr* call);
+        void flattenTerms(int idx, bool negated, std::vector<ObjectiveTerm>& out) const;
+        void collectVariables(int idx, std::vector<char>& used) const;
+        int fixedIndexSlot(const Node& n) const;
+        bool localOnly(int idx, int known) const;
+        bool collectVariablesAt(int idx, EvalContext& ctx, int known, std::vector<int>& out) const;
+    };
+
+    // decompose: 목적식 조각(slices)도 계산 (협력 공진화용)
+    CompiledModel compileModel(Program* program, const std::vector<Variable>& variables, double eqTolerance = 1e-9,
+                               bool decompose = false);
+
+    // 변수 없는 상수식 평가 (변수 범위 식 등)
+    double evalConstantExpr(Expression* expr);
+
+}
+
+#endif
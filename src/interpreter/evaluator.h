@@ -3,14 +3,20 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <memory>
 #include <functional>
 #include "ast.h"
 
 namespace hsl{
+    class CompiledModel;
+    class ModelProfiler;
+
     struct Variable {
         std::string name;
         std::pair<double, double> range;
         bool isInt;
+        double bandwidth = 0.0; // [VAR]의 bw (0: 파라미터로 결정)
     };
 
     struct HSProblem {
@@ -18,9 +24,50 @@ namespace hsl{
         std::function<double(const std::vector<double>&)> objective;
         std::function<double(const std::vector<double>&)> penalty;
         bool maximize;
+
+        // 난수 스트림을 지정하는 평가. rand()/randn()/randint()는 이 스트림에서만 뽑으므로
+        // 같은 (시드, 평가 번호)면 스레드와 무관하게 같은 값이 나온다. 비어 있으면 objective/penalty를 사용.
+        std::function<double(const std::vector<double>&, std::uint64_t)> objectiveSeeded;
+        std::function<double(const std::vector<double>&, std::uint64_t)> penaltySeeded;
+        bool stochastic = false; // 목적/제약에 난수 함수가 포함되었는지
+
+        // 제약 위반 크기의 합 (모두 만족하면 0). 비어 있으면 penalty로 대체
+        std::function<double(const std::vector<double>&, std::uint64_t)> violationSeeded;
+
+        // 제약별 위반 크기 (out[i]: i번째 제약, 만족하면 0)와 제약별로 식에 나타나는 변수 번호. 위반 후보 보정에 사용
+        std::function<void(const std::vector<double>&, std::uint64_t, std::vector<double>&)> constraintViolations;
+        std::vector<std::vector<int>> constraintVariables;
+
+        // 즉흥 연주/초기 표본을 평가하기 전에 적용하는 보정. 1차 등식 제약의 기준 변수를 닫힌 형태로 다시 계산한다.
+        // 보정할 등식이 없으면 비어 있음
+        std::function<void(std::vector<double>&)> repair;
+
+        // objective/penalty 계열을 여러 스레드에서 동시에 불러도 되는지 (HS-L 소스에서 만든 문제는 true)
+        bool parallelSafe = false;
+
+        // cutoff보다 나아질 수 없음이 확정되면 평가를 중단하고 false를 반환 (끝까지 평가하면 value를 채우고 true).
+        // 목적식이 단조 누적(음이 아닌 항들의 합 등)으로 분석된 경우에만 채워진다.
+        std::function<bool(const std::vector<double>&, std::uint64_t, double cutoff, double& value)> objectiveBounded;
+        std::shared_ptr<const CompiledModel> model; // HS-L 소스에서 만든 경우의 컴파일된 식 (직접 구성한 문제는 nullptr)
+
+        // [OBJ] ... external "명령": 목적 값을 계산할 외부 프로그램. 목적 함수 계열은 비어 있고 실행기가 채운다
+        std::string externalCommand;
+
+        // 후보 여러 개를 한 번에 평가 (values[k]: points[k]의 목적 값, streams[k]: 그 평가의 난수 스트림).
+        // 채워져 있으면 HS는 batchSize개씩 즉흥 연주해 한 번에 넘긴다. 목적 값이 NaN이면 평가 실패로 보고 버린다
+        std::function<void(const std::vector<std::vector<double>>& points, const std::vector<std::uint64_t>& streams,
+                           std::vector<double>& values)> objectiveBatch;
+        std::size_t batchSize = 1;
+
+        // --profile-model: 목적/제약 평가의 표본을 노드별로 시간 잰 기록 (꺼져 있으면 nullptr)
+        std::shared_ptr<ModelProfiler> profiler;
     };
 
-    HSProblem buildHSProblem(Program* program);
+    // eqTolerance: |l - r|이 이 값 미만이면 등식 제약 만족
+    // decompose: 협력 공진화용 목적식 조각도 준비 (model->slices)
+    // profileEvery > 0: 평가 profileEvery번 중 1번을 노드별로 시간 재며 계산 (HSProblem::profiler, 값은 같다)
+    HSProblem buildHSProblem(Program* program, double eqTolerance = 1e-9, bool decompose = false,
+                             unsigned profileEvery = 0);
 }
 
 #endif
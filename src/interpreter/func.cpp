@@ -1,37 +1,52 @@
 #include <cmath>
-#include <cstdlib>
 #include <numbers>
 #include <limits>
 #include "func.h"
 
 namespace hsl {
 
-    const std::unordered_map<std::string, BuiltinFunc>& builtinFunctions() {
-        static const std::unordered_map<std::string, BuiltinFunc> builtins = {
-                {"abs",   [](const std::vector<double>& a){ return std::fabs(a[0]); }},
-                {"sqrt",  [](const std::vector<double>& a){ return std::sqrt(a[0]); }},
-                {"exp",   [](const std::vector<double>& a){ return std::exp(a[0]); }},
-                {"log",   [](const std::vector<double>& a){ return std::log(a[0]); }},
-                {"log10", [](const std::vector<double>& a){ return std::log10(a[0]); }},
-                {"sin",   [](const std::vector<double>& a){ return std::sin(a[0]); }},
-                {"cos",   [](const std::vector<double>& a){ return std::cos(a[0]); }},
-                {"tan",   [](const std::vector<double>& a){ return std::tan(a[0]); }},
-                {"asin",  [](const std::vector<double>& a){ return std::asin(a[0]); }},
-                {"acos",  [](const std::vector<double>& a){ return std::acos(a[0]); }},
-                {"atan",  [](const std::vector<double>& a){ return std::atan(a[0]); }},
-                {"sinh",  [](const std::vector<double>& a){ return std::sinh(a[0]); }},
-                {"cosh",  [](const std::vector<double>& a){ return std::cosh(a[0]); }},
-                {"tanh",  [](const std::vector<double>& a){ return std::tanh(a[0]); }},
-                {"floor", [](const std::vector<double>& a){ return std::floor(a[0]); }},
-                {"ceil",  [](const std::vector<double>& a){ return std::ceil(a[0]); }},
-                {"round", [](const std::vector<double>& a){ return std::round(a[0]); }},
-                {"sign",  [](const std::vector<double>& a){ return (a[0] > 0) - (a[0] < 0); }},
-                {"rand",  [](const std::vector<double>&){ return std::rand() / static_cast<double>(RAND_MAX); }},
-                };
+    static std::unordered_map<std::string, BuiltinFunc>& builtinTable() {
+        static std::unordered_map<std::string, BuiltinFunc> builtins = [] {
+            std::unordered_map<std::string, BuiltinFunc> t;
+            auto add = [&t](const char* name, auto fn) { t[name] = BuiltinFunc(fn); };
+
+            add("abs",   +[](double a){ return std::fabs(a); });
+            add("sqrt",  +[](double a){ return std::sqrt(a); });
+            add("exp",   +[](double a){ return std::exp(a); });
+            add("log",   +[](double a){ return std::log(a); });
+            add("log10", +[](double a){ return std::log10(a); });
+            add("sin",   +[](double a){ return std::sin(a); });
+            add("cos",   +[](double a){ return std::cos(a); });
+            add("tan",   +[](double a){ return std::tan(a); });
+            add("asin",  +[](double a){ return std::asin(a); });
+            add("acos",  +[](double a){ return std::acos(a); });
+            add("atan",  +[](double a){ return std::atan(a); });
+            add("sinh",  +[](double a){ return std::sinh(a); });
+            add("cosh",  +[](double a){ return std::cosh(a); });
+            add("tanh",  +[](double a){ return std::tanh(a); });
+            add("floor", +[](double a){ return std::floor(a); });
+            add("ceil",  +[](double a){ return std::ceil(a); });
+            add("round", +[](double a){ return std::round(a); });
+            add("sign",  +[](double a){ return static_cast<double>((a > 0) - (a < 0)); });
+
+            for (const char* name : {"abs", "sqrt", "exp", "cosh"}) t[name].nonNegative = true;
+            return t;
+        }();
 
         return builtins;
     }
 
+    const BuiltinFunc* findBuiltin(const std::string& name) {
+        const auto& F = builtinTable();
+        auto it = F.find(name);
+        return it == F.end() ? nullptr : &it->second;
+    }
+
+    void registerBuiltin(const std::string& name, NativeFn0 fn) { builtinTable()[name] = BuiltinFunc(fn); }
+    void registerBuiltin(const std::string& name, NativeFn1 fn) { builtinTable()[name] = BuiltinFunc(fn); }
+    void registerBuiltin(const std::string& name, NativeFn2 fn) { builtinTable()[name] = BuiltinFunc(fn); }
+    void registerBuiltin(const std::string& name, NativeFn3 fn) { builtinTable()[name] = BuiltinFunc(fn); }
+
     const std::unordered_map<std::string, double>& builtinConstants() {
         static const std::unordered_map<std::string, double> constants = {
                 {"pi", std::numbers::pi},
@@ -2,15 +2,44 @@
 #define HSL_FUNC_
 
 #include <string>
-#include <vector>
 #include <unordered_map>
-#include <functional>
 
 namespace hsl {
 
-    using BuiltinFunc = std::function<double(const std::vector<double>&)>;
+    // 내장 함수는 인자 개수별 고정 시그니처의 일반 함수 포인터로 보관한다.
+    // (std::function / std::vector 인자 전달로 인한 평가 시점의 할당과 간접 호출 제거)
+    using NativeFn0 = double (*)();
+    using NativeFn1 = double (*)(double);
+    using NativeFn2 = double (*)(double, double);
+    using NativeFn3 = double (*)(double, double, double);
+
+    struct BuiltinFunc {
+        int arity = 0;
+        bool nonNegative = false; // 치역이 항상 >= 0 (abs, sqrt, exp 등). 조기 중단 분석에 사용
+        union {
+            NativeFn0 f0 = nullptr;
+            NativeFn1 f1;
+            NativeFn2 f2;
+            NativeFn3 f3;
+        };
+
+        BuiltinFunc() = default;
+        explicit BuiltinFunc(NativeFn0 f) : arity(0) { f0 = f; }
+        explicit BuiltinFunc(NativeFn1 f) : arity(1) { f1 = f; }
+        explicit BuiltinFunc(NativeFn2 f) : arity(2) { f2 = f; }
+        explicit BuiltinFunc(NativeFn3 f) : arity(3) { f3 = f; }
+    };
+
+    // 이름으로 내장 함수를 찾는다. 없으면 nullptr. (컴파일 시점에만 호출됨)
+    const BuiltinFunc* findBuiltin(const std::string& name);
+
+    // C++ 측에서 네이티브 내장 함수를 추가 등록. 같은 이름이면 덮어쓴다.
+    // 등록은 모델 컴파일(buildHSProblem) 이전에 끝나야 하며, 평가 비용은 기존 내장 함수와 동일하다.
+    void registerBuiltin(const std::string& name, NativeFn0 fn);
+    void registerBuiltin(const std::string& name, NativeFn1 fn);
+    void registerBuiltin(const std::string& name, NativeFn2 fn);
+    void registerBuiltin(const std::string& name, NativeFn3 fn);
 
-    const std::unordered_map<std::string, BuiltinFunc>& builtinFunctions();
     const std::unordered_map<std::string, double>& builtinConstants();
 
 }
@@ -109,6 +109,20 @@ namespace hsl {
                 tok = Token{TokenType::RBRACKET, "]", line, column};
                 break;
 
+            case '"': {
+                // 문자열은 같은 줄의 닫는 따옴표까지 (이스케이프 없음)
+                const int startCol = column;
+                std::string buf;
+                readChar();
+                while (ch != '"' && ch != '\n' && ch != '\0') {
+                    buf.push_back(ch);
+                    readChar();
+                }
+                if (ch != '"') return Token{TokenType::ILLEGAL, "\"" + buf, line, startCol};
+                tok = Token{TokenType::STRING, buf, line, startCol};
+                break;
+            }
+
             case '.':
                 if (peekChar() == '.') {
                     readChar();
@@ -59,10 +59,16 @@ namespace hsl {
         }
 
         nextToken();
+        if (curTokenIs(TokenType::IDENT) && curToken.literal == "external" && peekTokenIs(TokenType::STRING)) {
+            nextToken();
+            auto* obj = new Objective{isMax, nullptr, curToken.literal};
+            if (obj->external.empty()) errors.emplace_back("Empty command after 'external' in [OBJ]");
+            return obj;
+        }
         Expression* expr = parseExpression();
 
-        return new Objective{isMax, expr};
-    } // obj_decl ::= "[OBJ]" ("max" | "min") expression ;
+        return new Objective{isMax, expr, {}};
+    } // obj_decl ::= "[OBJ]" ("max" | "min") (expression | "external" string) ;
 
     VarDecl* Parser::parseVarDecl() {
         if (!curTokenIs(TokenType::VAR)) {
@@ -154,8 +160,26 @@ namespace hsl {
             return nullptr;
         }
 
-        return new VarDecl{name, lowerExpr, upperExpr, isInt};
-    } // var_decl ::= "[VAR]" identifier "," number "," number "," type ;
+        // 선택: 음정 조정 대역폭 (int 변수는 한 번에 움직일 최대 칸 수)
+        Expression* bandwidth = nullptr;
+        if (peekTokenIs(TokenType::COMMA)) {
+            nextToken();
+            if (!expectPeek(TokenType::IDENT)) return nullptr;
+            if (curToken.literal != "bw") {
+                errors.emplace_back("Unknown variable option '" + curToken.literal + "' (expected 'bw')");
+                return nullptr;
+            }
+            if (!expectPeek(TokenType::EQ)) return nullptr;
+            nextToken();
+            bandwidth = parseExpression();
+            if (!bandwidth) {
+                errors.emplace_back("Invalid expression as bandwidth");
+                return nullptr;
+            }
+        }
+
+        return new VarDecl{name, lowerExpr, upperExpr, isInt, bandwidth};
+    } // var_decl ::= "[VAR]" identifier "," number "," number "," type [ "," "bw" "=" number ] ;
 
     std::vector<VarDecl*> Parser::parseVarDeclList() {
         std::vector<VarDecl*> vars;
@@ -178,6 +202,7 @@ namespace hsl {
             errors.emplace_back("Expected [ST] at line " + std::to_string(curToken.line));
             return nullptr;
         }
+        const Token st = curToken;
 
         nextToken();
         Expression* left = parseExpression();
@@ -194,7 +219,10 @@ namespace hsl {
         nextToken();
         Expression* right = parseExpression();
 
-        return new Constraint{left, comp, right};
+        auto* c = new Constraint{left, comp, right};
+        c->line = st.line;
+        c->column = st.column;
+        return c;
     } // st_decl ::= "[ST]" expression comparator expression ;
 
     std::vector<Constraint*> Parser::parseStList() {
@@ -242,9 +270,10 @@ namespace hsl {
                 left = parseGroupedExpr();
                 break;
             case TokenType::MINUS: {
+                const Token minus = curToken;
                 nextToken();
                 Expression* right = parseExpression(static_cast<int>(Precedence::PREFIX));
-                left = new UnaryExpr{TokenType::MINUS, right};
+                left = located(new UnaryExpr{TokenType::MINUS, right}, minus);
                 break;
             }
             default:
@@ -256,6 +285,7 @@ namespace hsl {
                precedence < tokenPrecedence(peekToken.type)) {
             nextToken(); // 연산자
 
+            const Token opToken = curToken;
             TokenType op = curToken.type;
             int prec = tokenPrecedence(op);
             int nextPrec = (op == TokenType::CARET) ? prec - 1 : prec;
@@ -263,7 +293,7 @@ namespace hsl {
             nextToken();
             Expression* right = parseExpression(nextPrec);
 
-            left = new BinaryExpr{op, left, right};
+            left = located(new BinaryExpr{op, left, right}, opToken);
         }
 
         return left;
@@ -271,11 +301,12 @@ namespace hsl {
 
     Expression* Parser::parseIdentifier() {
         std::string name = curToken.literal;
+        const Token ident = curToken;
 
         // 함수 호출 - function :== IDENT "(" expression ")"
         if (peekTokenIs(TokenType::LPAREN)) {
             expectPeek(TokenType::LPAREN); // '(' 로 이동
-            return parseFunctionCall(name);
+            return located(parseFunctionCall(name), ident);
         }
 
         // index 호출 - index =
@@ -287,15 +318,15 @@ namespace hsl {
                 errors.emplace_back("Expected ']' after index expression");
                 return nullptr;
             }
-            return new IndexExpr{name, indexExpr};
+            return located(new IndexExpr{name, indexExpr}, ident);
         }
 
-        return new IdentExpr{name};
+        return located(new IdentExpr{name}, ident);
     }
 
     Expression* Parser::parseNumber() {
         bool isInt = (curToken.type == TokenType::NUMBER_INT);
-        return new NumberExpr{std::stod(curToken.literal), isInt};
+        return located(new NumberExpr{std::stod(curToken.literal), isInt}, curToken);
     }
 
     Expression* Parser::parseGroupedExpr() {
@@ -308,6 +339,14 @@ namespace hsl {
         return expr;
     }
 
+    Expression* Parser::located(Expression* expr, const Token& at) {
+        if (expr) {
+            expr->line = at.line;
+            expr->column = at.column;
+        }
+        return expr;
+    }
+
     int Parser::tokenPrecedence(TokenType t) const {
         switch (t) {
             case TokenType::PLUS:
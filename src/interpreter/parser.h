@@ -41,6 +41,8 @@ namespace hsl {
         Expression* parseFunctionCall(std::string funcName);
 
         [[nodiscard]] int tokenPrecedence(TokenType t) const;
+        // 식 노드에 토큰 위치를 기록 (nullptr이면 그대로)
+        static Expression* located(Expression* expr, const Token& at);
     };
 
     enum class Precedence {
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <utility>
+#include "profiler.h"
+#include "compiler.h"
+
+namespace hsl {
+
+    void ModelProfile::merge(const ModelProfile& other) {
+        auto add = [](std::vector<std::uint64_t>& to, const std::vector<std::uint64_t>& from) {
+            if (to.size() < from.size()) to.resize(from.size(), 0);
+            for (std::size_t i = 0; i < from.size(); ++i) to[i] += from[i];
+        };
+        add(calls, other.calls);
+        add(selfNs, other.selfNs);
+        add(totalNs, other.totalNs);
+        add(children, other.children);
+        add(descendants, other.descendants);
+        if (constraints.size() < other.constraints.size()) constraints.resize(other.constraints.size());
+        for (std::size_t i = 0; i < other.constraints.size(); ++i) {
+            constraints[i].calls += other.constraints[i].calls;
+            constraints[i].ns += other.constraints[i].ns;
+            constraints[i].nodes += other.constraints[i].nodes;
+        }
+        objective.calls += other.objective.calls;
+        objective.ns += other.objective.ns;
+        objective.nodes += other.objective.nodes;
+        samples += other.samples;
+    }
+
+    namespace {
+        std::atomic<std::uint64_t> nextProfilerId{1};
+
+        // 이 스레드가 마지막으로 쓴 (프로파일러, 칸)
+        struct LocalSlot {
+            std::uint64_t profiler = 0;
+            void* slot = nullptr;
+        };
+        thread_local LocalSlot lastSlot;
+
+        double median(std::vector<double> v) {
+            std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(v.size() / 2), v.end());
+            return v[v.size() / 2];
+        }
+
+        const char* opName(OpCode op) {
+            switch (op) {
+                case OpCode::CONST: return "const";
+                case OpCode::VAR: return "var";
+                case OpCode::LOCAL: return "index var";
+                case OpCode::INDEX: return "index";
+                case OpCode::NEG: return "negate";
+                case OpCode::ADD: return "+";
+                case OpCode::SUB: return "-";
+                case OpCode::MUL: return "*";
+                case OpCode::DIV: return "/";
+                case OpCode::POW: return "^";
+                case OpCode::CALL0:
+                case OpCode::CALL1:
+                case OpCode::CALL2:
+                case OpCode::CALL3: return "call";
+                case OpCode::SUM: return "sum";
+                case OpCode::PRODUCT: return "product";
+                case OpCode::RAND: return "rand";
+                case OpCode::RANDN: return "randn";
+                case OpCode::RANDINT: return "randint";
+            }
+            return "?";
+        }
+
+        // 소스 줄 나누기 (CR 제거)
+        std::vector<std::string> sourceLines(const std::string& source) {
+            std::vector<std::string> lines;
+            std::istringstream in(source);
+            std::string line;
+            while (std::getline(in, line)) {
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                lines.push_back(line);
+            }
+            return lines;
+        }
+
+        // 위치 주변의 소스 (앞 12자, 뒤 after자)
+        std::string excerpt(const std::vector<std::string>& lines, const SourcePos& at, std::size_t after = 28) {
+            if (at.line <= 0 || static_cast<std::size_t>(at.line) > lines.size()) return {};
+            const std::string& text = lines[static_cast<std::size_t>(at.line) - 1];
+            const std::size_t col = static_cast<std::size_t>(std::max(at.column, 1)) - 1;
+            const std::size_t from = col > 12 ? col - 12 : 0;
+            const std::size_t to = std::min(text.size(), col + after);
+            if (from >= to) return {};
+            std::string s = text.substr(from, to - from);
+            const std::size_t first = s.find_first_not_of(" \t");
+            const std::size_t last = s.find_last_not_of(" \t");
+            s = first == std::string::npos ? std::string{} : s.substr(first, last - first + 1);
+            return (from > 0 ? "..." : "") + s + (to < text.size() ? "..." : "");
+        }
+
+        std::string location(const SourcePos& at) {
+            if (at.line <= 0) return "-";
+            return std::to_string(at.line) + ":" + std::to_string(at.column);
+        }
+
+        double corrected(std::uint64_t ns, double overhead) {
+            return std::max(0.0, static_cast<double>(ns) - overhead);
+        }
+    }
+
+    ModelProfiler::ModelProfiler(std::shared_ptr<const CompiledModel> model, unsigned every)
+            : model(std::move(model)), every(std::max(every, 1u)), id(nextProfilerId++) {
+        calibrate();
+    }
+
+    // (1 + 2) + 3 꼴의 덧셈 사슬을 표본 평가로 돌려 시계/기록 비용을 잰다.
+    // 안쪽 덧셈(잰 자식 없음)의 자기 시간 = inside, 바깥 덧셈(잰 자식 1개)의 자기 시간 - inside = outside.
+    // 덧셈 자체는 1ns 안팎이라 무시한다
+    void ModelProfiler::calibrate() {
+        CompiledModel chain;
+        auto push = [&](OpCode op, int a, int b) {
+            Node n;
+            n.op = op;
+            n.a = a;
+            n.b = b;
+            n.value = 1.0;
+            chain.nodes.push_back(n);
+            return static_cast<int>(chain.nodes.size()) - 1;
+        };
+        const int inner = push(OpCode::ADD, push(OpCode::CONST, -1, -1), push(OpCode::CONST, -1, -1));
+        const int outer = push(OpCode::ADD, inner, push(OpCode::CONST, -1, -1));
+        const std::size_t n = chain.nodes.size();
+
+        constexpr int batches = 101, perBatch = 32;
+        std::vector<double> in(batches), out(batches);
+        for (int k = 0; k < batches; ++k) {
+            ModelProfile p;
+            p.calls.assign(n, 0);
+            p.selfNs.assign(n, 0);
+            p.totalNs.assign(n, 0);
+            p.children.assign(n, 0);
+            p.descendants.assign(n, 0);
+            EvalContext ctx;
+            ctx.profile = &p;
+            for (int i = 0; i < perBatch; ++i) chain.evalProfiled(outer, ctx);
+            in[k] = static_cast<double>(p.selfNs[inner]) / perBatch;
+            out[k] = static_cast<double>(p.selfNs[outer]) / perBatch;
+        }
+        insideNs = median(in);
+        outsideNs = std::max(0.0, median(out) - insideNs);
+    }
+
+    ModelProfiler::Slot& ModelProfiler::local() {
+        if (lastSlot.profiler == id) return *static_cast<Slot*>(lastSlot.slot);
+        std::lock_guard<std::mutex> lock(m);
+        const auto self = std::this_thread::get_id();
+        Slot* slot = nullptr;
+        for (auto& s : slots)
+            if (s.thread == self) slot = &s;
+        if (!slot) {
+            slots.emplace_back();
+            slot = &slots.back();
+            slot->thread = self;
+            const std::size_t n = model->nodes.size();
+            ModelProfile& p = slot->profile;
+            p.calls.assign(n, 0);
+            p.selfNs.assign(n, 0);
+            p.totalNs.assign(n, 0);
+            p.children.assign(n, 0);
+            p.descendants.assign(n, 0);
+            p.constraints.assign(model->constraints.size(), {});
+        }
+        lastSlot = {id, slot};
+        return *slot;
+    }
+
+    ModelProfile* ModelProfiler::sample(unsigned& countdown, ModelProfile& profile) const {
+        if (countdown) {
+            --countdown;
+            return nullptr;
+        }
+        countdown = every - 1;
+        ++profile.samples;
+        profile.childNs = 0;
+        profile.childCalls = 0;
+        return &profile;
+    }
+
+    ModelProfile* ModelProfiler::sampleObjective() {
+        Slot& s = local();
+        return sample(s.objectiveCountdown, s.profile);
+    }
+
+    ModelProfile* ModelProfiler::sampleConstraints() {
+        if (model->constraints.empty()) return nullptr;
+        Slot& s = local();
+        return sample(s.constraintCountdown, s.profile);
+    }
+
+    ModelProfile ModelProfiler::collect() const {
+        std::lock_guard<std::mutex> lock(m);
+        ModelProfile total;
+        total.calls.assign(model->nodes.size(), 0);
+        total.constraints.assign(model->constraints.size(), {});
+        for (const auto& s : slots) total.merge(s.profile);
+        return total;
+    }
+
+    void printModelProfile(std::ostream& os, const ModelProfiler& profiler, const std::string& source) {
+        const CompiledModel& model = profiler.compiled();
+        const ModelProfile p = profiler.collect();
+        const double in = profiler.overheadInside(), out = profiler.overheadOutside();
+        const auto lines = sourceLines(source);
+        auto at = [&](int idx) {
+            return static_cast<std::size_t>(idx) < model.sources.size() ? model.sources[idx] : SourcePos{};
+        };
+
+        std::ostringstream t;
+        t << std::fixed << std::setprecision(1);
+        t << "[INFO] Model profile (1 of every " << profiler.interval() << " evaluations, " << p.samples
+          << " sampled; timer cost " << in + out << " ns per node subtracted)\n";
+        if (!p.objective.calls && std::none_of(p.constraints.begin(), p.constraints.end(),
+                                               [](const ProfileCost& c) { return c.calls > 0; })) {
+            os << t.str() << "  (no evaluation went through the compiled model)" << std::endl;
+            return;
+        }
+
+        // 구간 시간에는 그 안에서 잰 노드마다 시계/기록 비용 전체가 들어 있다
+        auto spanNs = [&](const ProfileCost& c) { return corrected(c.ns, (in + out) * static_cast<double>(c.nodes)); };
+        double sampled = spanNs(p.objective);
+        for (const auto& c : p.constraints) sampled += spanNs(c);
+        auto share = [&](double ns) { return sampled > 0.0 ? 100.0 * ns / sampled : 0.0; };
+        auto perCall = [](double ns, std::uint64_t calls) { return calls ? ns / static_cast<double>(calls) : 0.0; };
+
+        const std::size_t n = model.nodes.size();
+        std::vector<double> self(n, 0.0), total(n, 0.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!p.calls[i]) continue;
+            self[i] = corrected(p.selfNs[i], in * static_cast<double>(p.calls[i]) + out * static_cast<double>(p.children[i]));
+            total[i] = corrected(p.totalNs[i], in * static_cast<double>(p.calls[i])
+                                               + (in + out) * static_cast<double>(p.descendants[i]));
+        }
+
+        t << "  objective    " << std::setw(10) << p.objective.calls << " evaluations "
+          << std::setw(10) << perCall(spanNs(p.objective), p.objective.calls) << " ns each "
+          << std::setw(6) << share(spanNs(p.objective)) << "%\n";
+
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return self[a] > self[b]; });
+        t << "  hottest expressions (self time: children excluded)\n";
+        t << "    " << std::left << std::setw(9) << "line:col" << std::setw(9) << "node" << std::right
+          << std::setw(12) << "calls" << std::setw(11) << "self ns" << std::setw(8) << "share"
+          << std::setw(11) << "total ns" << "  source\n";
+        for (std::size_t k = 0; k < order.size() && k < 15; ++k) {
+            const std::size_t i = order[k];
+            if (!p.calls[i]) break;
+            t << "    " << std::left << std::setw(9) << location(at(static_cast<int>(i)))
+              << std::setw(9) << opName(model.nodes[i].op) << std::right << std::setw(12) << p.calls[i]
+              << std::setw(11) << perCall(self[i], p.calls[i]) << std::setw(7) << share(self[i]) << "%"
+              << std::setw(11) << perCall(total[i], p.calls[i]) << "  " << excerpt(lines, at(static_cast<int>(i)))
+              << "\n";
+        }
+
+        // sum/product 본문: 본문 노드의 포함 시간 (본문이 잎이면 sum 노드의 자기 시간)
+        struct Body {
+            std::size_t node;
+            std::uint64_t iterations;
+            double ns;
+        };
+        std::vector<Body> bodies;
+        for (std::size_t i = 0; i < n; ++i) {
+            const Node& node = model.nodes[i];
+            if (node.op != OpCode::SUM && node.op != OpCode::PRODUCT) continue;
+            const auto c = static_cast<std::size_t>(node.c);
+            if (p.calls[c]) bodies.push_back({i, p.calls[c], total[c]});
+            else if (p.calls[i]) bodies.push_back({i, 0, self[i]});
+        }
+        std::sort(bodies.begin(), bodies.end(), [](const Body& a, const Body& b) { return a.ns > b.ns; });
+        if (!bodies.empty()) {
+            t << "  sum/product bodies\n";
+            t << "    " << std::left << std::setw(9) << "line:col" << std::setw(9) << "node" << std::right
+              << std::setw(12) << "iterations" << std::setw(11) << "ns/iter" << std::setw(8) << "share" << "  source\n";
+            for (std::size_t k = 0; k < bodies.size() && k < 10; ++k) {
+                const Body& b = bodies[k];
+                t << "    " << std::left << std::setw(9) << location(at(static_cast<int>(b.node)))
+                  << std::setw(9) << opName(model.nodes[b.node].op) << std::right;
+                if (b.iterations) t << std::setw(12) << b.iterations << std::setw(11) << perCall(b.ns, b.iterations);
+                else t << std::setw(12) << "-" << std::setw(11) << "-"; // 본문이 잎이면 반복 수를 세지 않는다
+                t << std::setw(7) << share(b.ns) << "%  " << excerpt(lines, at(static_cast<int>(b.node))) << "\n";
+            }
+        }
+
+        if (!model.constraints.empty()) {
+            std::vector<std::size_t> byCost(model.constraints.size());
+            std::iota(byCost.begin(), byCost.end(), 0);
+            std::sort(byCost.begin(), byCost.end(), [&](std::size_t a, std::size_t b) {
+                return spanNs(p.constraints[a]) > spanNs(p.constraints[b]);
+            });
+            t << "  constraints\n";
+            t << "    " << std::left << std::setw(9) << "line:col" << std::setw(9) << "[ST]" << std::right
+              << std::setw(12) << "checks" << std::setw(11) << "ns each" << std::setw(8) << "share" << "  source\n";
+            for (std::size_t k = 0; k < byCost.size() && k < 15; ++k) {
+                const std::size_t i = byCost[k];
+                const ProfileCost& c = p.constraints[i];
+                const double ns = spanNs(c);
+                t << "    " << std::left << std::setw(9) << location(model.constraints[i].source)
+                  << std::setw(9) << ("#" + std::to_string(i + 1)) << std::right << std::setw(12) << c.calls
+                  << std::setw(11) << perCall(ns, c.calls) << std::setw(7) << share(ns) << "%  "
+                  << excerpt(lines, model.constraints[i].source, 56) << "\n";
+            }
+            if (byCost.size() > 15) t << "    ... " << byCost.size() - 15 << " more\n";
+        }
+        std::string text = t.str();
+        text.pop_back();
+        os << text << std::endl;
+    }
+
+}
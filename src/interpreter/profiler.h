@@ -0,0 +1,117 @@
+#ifndef HSL_PROFILER_
+#define HSL_PROFILER_
+// 모델 프로파일 (--profile-model). 평가 N번 중 1번을 노드마다 시간을 재며 계산하고,
+// 노드/sum 본문/제약별 비용을 소스의 줄:열로 되짚어 보고한다.
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hsl {
+
+    class CompiledModel;
+
+    // 시간을 잰 구간 하나의 누적 (nodes: 그 안에서 시간을 잰 노드 수, 시계 비용 보정용)
+    struct ProfileCost {
+        std::uint64_t calls = 0;
+        std::uint64_t ns = 0;
+        std::uint64_t nodes = 0;
+    };
+
+    // 스레드 하나의 표본 기록. 노드 번호는 CompiledModel::nodes와 같다
+    struct ModelProfile {
+        std::vector<std::uint64_t> calls;       // 노드별 시간을 잰 평가 수
+        std::vector<std::uint64_t> selfNs;      // 자식 노드를 뺀 시간 (CONST/VAR/LOCAL/RAND 등 잎 노드는 부모에 포함)
+        std::vector<std::uint64_t> totalNs;     // 자식 포함
+        std::vector<std::uint64_t> children;    // 시간을 잰 직계 자식 호출 수
+        std::vector<std::uint64_t> descendants; // 시간을 잰 모든 자손 호출 수
+        std::vector<ProfileCost> constraints;   // [ST]별
+        ProfileCost objective;
+        std::uint64_t samples = 0;              // 표본으로 고른 평가 (목적 함수 또는 제약 검사 한 번)
+
+        // evalProfiled가 쓰는 작업 값: 지금 노드의 직계 자식 시간/호출 수, 지금까지 잰 노드 수
+        std::uint64_t childNs = 0;
+        std::uint64_t childCalls = 0;
+        std::uint64_t timed = 0;
+
+        void merge(const ModelProfile& other);
+
+        static std::uint64_t now() {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // 수명 동안의 시간과 그 안에서 잰 노드 수를 cost에 더한다
+        class Span {
+        public:
+            Span(ModelProfile& p, ProfileCost& cost) : p(p), cost(cost), nodes(p.timed), begin(now()) {}
+            ~Span() {
+                cost.ns += now() - begin;
+                cost.nodes += p.timed - nodes;
+                ++cost.calls;
+            }
+            Span(const Span&) = delete;
+            Span& operator=(const Span&) = delete;
+
+        private:
+            ModelProfile& p;
+            ProfileCost& cost;
+            std::uint64_t nodes;
+            std::uint64_t begin;
+        };
+    };
+
+    // 스레드별 ModelProfile 모음과 표본 선택. sample()은 처음 부를 때만 잠근다 (CounterSet과 같은 방식)
+    class ModelProfiler {
+    public:
+        // every번의 평가 중 1번을 표본으로 고른다 (1이면 모든 평가)
+        ModelProfiler(std::shared_ptr<const CompiledModel> model, unsigned every);
+        ModelProfiler(const ModelProfiler&) = delete;
+        ModelProfiler& operator=(const ModelProfiler&) = delete;
+
+        // 이번 평가가 표본이면 이 스레드의 기록, 아니면 nullptr.
+        // 목적 함수와 제약 검사는 따로 센다 (번갈아 부르는 순서와 every가 맞물려 한쪽만 뽑히지 않도록)
+        ModelProfile* sampleObjective();
+        ModelProfile* sampleConstraints();
+        // 모든 스레드의 합. 다른 스레드가 평가 중이 아닐 때 부른다
+        [[nodiscard]] ModelProfile collect() const;
+        [[nodiscard]] const CompiledModel& compiled() const { return *model; }
+        [[nodiscard]] unsigned interval() const { return every; }
+        // 시간을 잰 노드 하나가 자기 구간(inside)과 부모 구간(outside)에 더하는 시계/기록 비용 (ns, 시작 시 측정)
+        [[nodiscard]] double overheadInside() const { return insideNs; }
+        [[nodiscard]] double overheadOutside() const { return outsideNs; }
+
+    private:
+        struct Slot {
+            std::thread::id thread;
+            ModelProfile profile;
+            unsigned objectiveCountdown = 0;
+            unsigned constraintCountdown = 0;
+        };
+
+        std::shared_ptr<const CompiledModel> model;
+        unsigned every;
+        double insideNs = 0.0;
+        double outsideNs = 0.0;
+        std::uint64_t id;                 // thread_local 캐시 구분용 (재사용하지 않음)
+        mutable std::mutex m;
+        std::deque<Slot> slots;           // deque: 참조가 유지됨
+
+        Slot& local();
+        ModelProfile* sample(unsigned& countdown, ModelProfile& profile) const;
+        void calibrate();
+    };
+
+    // 노드(자기 시간), sum/product 본문, 제약별 비용 표. source가 있으면 해당 줄의 발췌도 붙인다
+    void printModelProfile(std::ostream& os, const ModelProfiler& profiler, const std::string& source);
+
+}
+
+#endif
@@ -13,6 +13,7 @@ namespace hsl {
         // 리터럴
         IDENT,      // 변수명, 함수명
         NUMBER_INT, NUMBER_FLOAT,     // 정수/실수(double)
+        STRING,     // "..." (외부 목적 함수 명령)
 
         // 연산자
         PLUS, MINUS, ASTERISK, SLASH,
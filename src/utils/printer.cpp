@@ -47,7 +47,8 @@ namespace hsl{
         // Objective
         if (prg->obj) {
             indentPrint(indent+1, prg->obj->isMax ? "Objective: max" : "Objective: min");
-            printExpr(prg->obj->expr, indent+2);
+            if (prg->obj->expr) printExpr(prg->obj->expr, indent+2);
+            else indentPrint(indent+2, "External(\"" + prg->obj->external + "\")");
         }
 
         // Vars
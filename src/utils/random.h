@@ -0,0 +1,42 @@
+#ifndef HSL_RANDOM_
+#define HSL_RANDOM_
+// 평가 컨텍스트별 난수 스트림. 전역 상태(std::rand) 없이 실행 시드에서 결정적으로 파생된다.
+
+#include <cstdint>
+#include <cmath>
+#include <numbers>
+
+namespace hsl {
+
+    // splitmix64 - 상태가 64bit 하나라 컨텍스트마다 복사/보관 비용이 거의 없다.
+    struct SplitMix64 {
+        std::uint64_t state = 0;
+
+        std::uint64_t next() {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        // [0, 1)
+        double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+        // 표준정규분포 (Box-Muller)
+        double normal() {
+            double u1 = 1.0 - uniform(); // (0, 1]
+            double u2 = uniform();
+            return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * std::numbers::pi * u2);
+        }
+    };
+
+    // (실행 시드, 평가 번호) -> 스트림 시드. 어느 스레드가 몇 번째로 평가하든 같은 번호면 같은 난수열이 나온다.
+    inline std::uint64_t deriveStream(std::uint64_t seed, std::uint64_t index) {
+        SplitMix64 g{seed ^ (index * 0xD1B54A32D192ED03ull)};
+        g.next();
+        return g.next();
+    }
+
+}
+
+#endif
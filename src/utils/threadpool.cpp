@@ -0,0 +1,111 @@
+#include "threadpool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace hsl {
+
+    ThreadPool::ThreadPool(unsigned threads) {
+        workers.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            stopping = true;
+        }
+        cv.notify_all();
+        workers.clear(); // jthread 소멸자에서 join
+    }
+
+    ThreadPool& ThreadPool::shared() {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    // 묶음에서 인덱스를 하나씩 가져가 실행. 마지막으로 끝낸 스레드가 대기 중인 호출자를 깨운다.
+    void ThreadPool::runSome(Batch& b) {
+        for (;;) {
+            std::size_t k = b.next.fetch_add(1, std::memory_order_relaxed);
+            if (k >= b.count) return;
+            try {
+                (*b.fn)(k);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(b.m);
+                if (!b.error) b.error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lk(b.m);
+            if (++b.done == b.count) b.cv.notify_all();
+        }
+    }
+
+    void ThreadPool::workerLoop() {
+        for (;;) {
+            std::shared_ptr<Batch> b;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk, [this] { return stopping || !queue.empty(); });
+                if (stopping) return;
+                b = queue.front();
+                // 나눠줄 인덱스가 다 떨어진 묶음은 큐에서 뺀다
+                if (b->next.load(std::memory_order_relaxed) >= b->count) {
+                    queue.pop_front();
+                    continue;
+                }
+            }
+            runSome(*b);
+        }
+    }
+
+    void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn) {
+        if (count == 0) return;
+        if (workers.empty() || count == 1) {
+            for (std::size_t k = 0; k < count; ++k) fn(k);
+            return;
+        }
+
+        auto b = std::make_shared<Batch>();
+        b->fn = &fn;
+        b->count = count;
+        {
+            std::lock_guard<std::mutex> lk(m);
+            queue.push_back(b);
+        }
+        cv.notify_all();
+
+        runSome(*b);
+        {
+            std::unique_lock<std::mutex> lk(b->m);
+            b->cv.wait(lk, [&] { return b->done == b->count; });
+        }
+        {
+            std::lock_guard<std::mutex> lk(m);
+            auto it = std::find(queue.begin(), queue.end(), b);
+            if (it != queue.end()) queue.erase(it);
+        }
+        if (b->error) std::rethrow_exception(b->error);
+    }
+
+    double ThreadPool::dispatchOverheadNs() {
+        double cached = overheadNs.load(std::memory_order_relaxed);
+        if (cached >= 0.0) return cached;
+
+        // 빈 작업을 작업자 수만큼 나눠주는 시간의 중앙값
+        std::function<void(std::size_t)> noop = [](std::size_t) {};
+        std::vector<double> samples;
+        for (int r = 0; r < 9; ++r) {
+            auto t0 = std::chrono::steady_clock::now();
+            parallelFor(concurrency(), noop);
+            auto t1 = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        double ns = samples[samples.size() / 2];
+        overheadNs.store(ns, std::memory_order_relaxed);
+        return ns;
+    }
+
+}
@@ -0,0 +1,64 @@
+#ifndef HSL_THREADPOOL_
+#define HSL_THREADPOOL_
+// 코어 수만큼의 작업자 스레드를 두고 parallelFor 단위로 일을 나눠주는 스레드 풀.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "jthread.h"
+
+namespace hsl {
+
+    class ThreadPool {
+    public:
+        // threads: 작업자 스레드 수 (호출 스레드도 함께 일하므로 병렬도는 threads + 1)
+        explicit ThreadPool(unsigned threads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // fn(0) ... fn(count - 1)을 나눠 실행하고 모두 끝날 때까지 대기. 예외는 호출 스레드로 다시 던진다.
+        // 여러 스레드에서 동시에 호출해도 된다.
+        void parallelFor(std::size_t count, const std::function<void(std::size_t)>& fn);
+
+        // 호출 스레드를 포함한 병렬도
+        [[nodiscard]] unsigned concurrency() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+        // 빈 작업 묶음 하나를 나눠주고 기다리는 데 드는 시간(ns). 병렬화 손익분기 계산용으로 한 번만 측정.
+        double dispatchOverheadNs();
+
+        // 프로세스 공용 풀 (hardware_concurrency - 1 작업자)
+        static ThreadPool& shared();
+
+    private:
+        struct Batch {
+            const std::function<void(std::size_t)>* fn = nullptr;
+            std::size_t count = 0;
+            std::atomic<std::size_t> next{0};
+            std::size_t done = 0;
+            std::exception_ptr error;
+            std::mutex m;
+            std::condition_variable cv;
+        };
+
+        std::mutex m;
+        std::condition_variable cv;
+        std::deque<std::shared_ptr<Batch>> queue;
+        bool stopping = false;
+        std::vector<jthread> workers;
+        std::atomic<double> overheadNs{-1.0};
+
+        void workerLoop();
+        static void runSome(Batch& b);
+    };
+
+}
+
+#endif